@@ -0,0 +1,152 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "ArgParse/argparse.hpp"
+#include "Automata/BinaryTable.hpp"
+#include "Automata/TableGenerator.hpp"
+#include "Automata/TableWriter.hpp"
+
+// Writes a seeded random table, input of the main tool for benchmarks and tests:
+//   automata_generate mealy table.csv --states 100000 --inputs 8 --seed 7
+namespace
+{
+
+constexpr auto KIND_PAR = "<kind>";
+constexpr auto OUTPUT_FILE_PAR = "<output-file>";
+constexpr auto MEALY_KIND = "mealy";
+constexpr auto MOORE_KIND = "moore";
+constexpr auto NFA_KIND = "nfa";
+
+argparse::ArgumentParser ParseArgs(int argc, char* argv[])
+{
+	argparse::ArgumentParser program("automata_generate", "0.0.1");
+
+	program.add_description("Generates random Mealy|Moore|NFA tables.");
+
+	program.add_argument(KIND_PAR)
+		.help("kind of the table {" + std::string(MEALY_KIND) + '|' + std::string(MOORE_KIND) + '|' + std::string(NFA_KIND) + '}')
+		.required();
+
+	program.add_argument(OUTPUT_FILE_PAR)
+		.help("destination file")
+		.required();
+
+	program.add_argument("--states")
+		.help("states count, of one copy with --copies")
+		.default_value(size_t{ 1000 })
+		.scan<'u', size_t>();
+
+	program.add_argument("--inputs")
+		.help("inputs count")
+		.default_value(size_t{ 4 })
+		.scan<'u', size_t>();
+
+	program.add_argument("--signals")
+		.help("output signals count, tokens count of NFA")
+		.default_value(size_t{ 2 })
+		.scan<'u', size_t>();
+
+	program.add_argument("--reachable")
+		.help("share of states reachable from the start state")
+		.default_value(1.0)
+		.scan<'g', double>();
+
+	program.add_argument("--max-targets")
+		.help("max targets count of NFA cell")
+		.default_value(size_t{ 2 })
+		.scan<'u', size_t>();
+
+	program.add_argument("--epsilon")
+		.help("share of NFA states with epsilon transition")
+		.default_value(0.1)
+		.scan<'g', double>();
+
+	program.add_argument("--copies")
+		.help("copies of every Mealy|Moore state, which minimization merges")
+		.default_value(size_t{ 1 })
+		.scan<'u', size_t>();
+
+	program.add_argument("--seed")
+		.help("seed of the random generator")
+		.default_value(std::uint32_t{ 42 })
+		.scan<'u', std::uint32_t>();
+
+	program.add_argument("--out-format")
+		.help("format of Mealy|Moore table {csv|bin}, NFA is always csv")
+		.default_value(std::string("csv"));
+
+	try
+	{
+		program.parse_args(argc, argv);
+		auto& kind = program.get(KIND_PAR);
+		if (kind != MEALY_KIND && kind != MOORE_KIND && kind != NFA_KIND)
+		{
+			throw std::invalid_argument("Wrong " + std::string(KIND_PAR) + " provided. See help");
+		}
+	}
+	catch (const std::exception& err)
+	{
+		std::cerr << err.what() << std::endl;
+		std::cerr << program;
+		std::exit(1);
+	}
+
+	return program;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	auto program = ParseArgs(argc, argv);
+
+	GeneratorParams params{};
+	params.m_statesCount = program.get<size_t>("--states");
+	params.m_inputsCount = program.get<size_t>("--inputs");
+	params.m_signalsCount = program.get<size_t>("--signals");
+	params.m_reachableShare = program.get<double>("--reachable");
+	params.m_maxTargetsCount = program.get<size_t>("--max-targets");
+	params.m_epsilonShare = program.get<double>("--epsilon");
+	params.m_copiesCount = program.get<size_t>("--copies");
+	params.m_seed = program.get<std::uint32_t>("--seed");
+
+	auto& kind = program.get(KIND_PAR);
+	auto binaryOutput = program.get("--out-format") == "bin";
+
+	try
+	{
+		auto generator = TableGenerator{ params };
+		std::ofstream oFS{ program.get(OUTPUT_FILE_PAR), binaryOutput ? std::ios::binary : std::ios::out };
+		auto writeTable = [&](const auto& table) {
+			if (binaryOutput)
+			{
+				BinaryTableWriter{ oFS }.Write(table);
+			}
+			else
+			{
+				TableWriter{ oFS }.Write(table);
+			}
+		};
+
+		if (kind == MEALY_KIND)
+		{
+			writeTable(generator.MakeMealyTable());
+		}
+		if (kind == MOORE_KIND)
+		{
+			writeTable(generator.MakeMooreTable());
+		}
+		if (kind == NFA_KIND)
+		{
+			TableWriter{ oFS }.Write(generator.MakeNfaTable());
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << e.what() << std::endl;
+		std::exit(1);
+	}
+
+	return 0;
+}
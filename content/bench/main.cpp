@@ -0,0 +1,428 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "Automata/BatchSimulator.hpp"
+#include "Automata/BinaryTable.hpp"
+#include "Automata/Lexer.hpp"
+#include "Automata/MealyTableReader.hpp"
+#include "Automata/Simulator.hpp"
+#include "Automata/TableGenerator.hpp"
+#include "Automata/TableWriter.hpp"
+
+// Prints results as ';'-separated lines: benchmark;size;seconds;items per second
+namespace
+{
+
+constexpr size_t LEXER_INPUT_SIZE = 64 << 20;
+constexpr size_t SIMULATION_INPUT_SIZE = 64 << 20;
+constexpr size_t SIMULATION_STATES_COUNT = 10000;
+constexpr size_t SIMULATION_INPUTS_COUNT = 16;
+constexpr size_t SIMULATION_SIGNALS_COUNT = 8;
+constexpr size_t SIMULATION_CYCLE_STATES_COUNT = 1000;
+constexpr size_t BATCH_STREAMS_COUNT = 100000;
+constexpr size_t BATCH_MAX_STREAM_SIZE = 500;
+constexpr size_t TABLES_MIN_STATES_COUNT = 1000;
+constexpr size_t TABLES_MAX_STATES_COUNT = 1000000;
+constexpr size_t TABLES_INPUTS_COUNT = 4;
+constexpr size_t TABLES_SIGNALS_COUNT = 2;
+constexpr double TABLES_REACHABLE_SHARE = 0.9;
+constexpr std::uint32_t SEED = 42;
+
+template <typename Fn>
+double MeasureSeconds(Fn&& fn)
+{
+	auto start = std::chrono::steady_clock::now();
+	fn();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void PrintResult(std::string_view benchmark, size_t size, double seconds, double items)
+{
+	std::cout << benchmark << ';' << size << ';' << seconds << ';' << items / seconds << std::endl;
+}
+
+enum LexerToken : std::uint32_t
+{
+	IDENTIFIER = 0,
+	NUMBER,
+	SPACE,
+	OPERATOR,
+	STRING,
+};
+
+const LexerTable::Rules LEXER_RULES = {
+	"[A-Za-z_][A-Za-z0-9_]*",
+	"[0-9]+(\\.[0-9]+)?",
+	"[ \\t\\r\\n]+",
+	"[-+*/%=<>!&|^~?:;,.(){}\\[\\]]|==|!=|<=|>=|&&|\\|\\||<<|>>|->",
+	"\"([^\"\\\\\\n]|\\\\.)*\"",
+};
+
+// Source-like text of identifiers, numbers, operators and strings separated by spaces
+std::string GenerateLexerInput(size_t size)
+{
+	static constexpr std::string_view letters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_";
+	static constexpr std::string_view operators[] = { "+", "-", "*", "=", "==", "!=", "<=", "&&", "->", "(", ")", "{", "}", ";", "," };
+
+	std::mt19937 random{ SEED };
+	std::string result{};
+	result.reserve(size + 64);
+	while (result.size() < size)
+	{
+		switch (random() % 5)
+		{
+		case 0:
+		case 1:
+			for (auto length = 1 + random() % 10; length-- > 0;)
+			{
+				result += letters[random() % letters.size()];
+			}
+			break;
+		case 2:
+			result += std::to_string(random() % 100000);
+			break;
+		case 3:
+			result += operators[random() % std::size(operators)];
+			break;
+		default:
+			result += "\"text ";
+			result += std::to_string(random());
+			result += '"';
+			break;
+		}
+		result += random() % 8 == 0 ? '\n' : ' ';
+	}
+
+	return result;
+}
+
+bool IsIdentifierStart(char ch) noexcept
+{
+	return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_';
+}
+
+bool IsDigit(char ch) noexcept
+{
+	return ch >= '0' && ch <= '9';
+}
+
+// Hand-written scanner of the same rules, the baseline of the table-driven lexer
+size_t MatchByHand(std::string_view text, std::uint32_t& token) noexcept
+{
+	auto ch = text[0];
+	size_t length = 1;
+	if (IsIdentifierStart(ch))
+	{
+		while (length < text.size() && (IsIdentifierStart(text[length]) || IsDigit(text[length])))
+		{
+			++length;
+		}
+		token = IDENTIFIER;
+		return length;
+	}
+	if (IsDigit(ch))
+	{
+		while (length < text.size() && IsDigit(text[length]))
+		{
+			++length;
+		}
+		if (length + 1 < text.size() && text[length] == '.' && IsDigit(text[length + 1]))
+		{
+			length += 2;
+			while (length < text.size() && IsDigit(text[length]))
+			{
+				++length;
+			}
+		}
+		token = NUMBER;
+		return length;
+	}
+	if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n')
+	{
+		while (length < text.size() && (text[length] == ' ' || text[length] == '\t' || text[length] == '\r' || text[length] == '\n'))
+		{
+			++length;
+		}
+		token = SPACE;
+		return length;
+	}
+	if (ch == '"')
+	{
+		while (length < text.size() && text[length] != '"' && text[length] != '\n')
+		{
+			length += text[length] == '\\' && length + 1 < text.size() ? 2 : 1;
+		}
+		if (length < text.size() && text[length] == '"')
+		{
+			token = STRING;
+			return length + 1;
+		}
+	}
+
+	static constexpr std::string_view pairs[] = { "==", "!=", "<=", ">=", "&&", "||", "<<", ">>", "->" };
+	for (auto pair : pairs)
+	{
+		if (text.starts_with(pair))
+		{
+			token = OPERATOR;
+			return pair.size();
+		}
+	}
+	token = std::string_view{ "+-*/%=<>!&|^~?:;,.(){}[]" }.find(ch) != std::string_view::npos
+		? OPERATOR
+		: LexerTable::NO_TOKEN;
+	return 1;
+}
+
+void BenchLexer()
+{
+	auto input = GenerateLexerInput(LEXER_INPUT_SIZE);
+
+	std::optional<LexerTable> table{};
+	auto buildSeconds = MeasureSeconds([&] { table.emplace(LEXER_RULES); });
+	PrintResult("lexer/build", table->GetStatesCount(), buildSeconds, 1);
+
+	size_t tableTokens = 0;
+	std::uint64_t tableChecksum = 0;
+	auto tableSeconds = MeasureSeconds([&] {
+		Token token{};
+		for (Lexer lexer{ *table, input }; lexer.Next(token); ++tableTokens)
+		{
+			tableChecksum += token.m_id + token.m_text.size();
+		}
+	});
+	PrintResult("lexer/table", input.size(), tableSeconds, static_cast<double>(input.size()));
+
+	size_t handTokens = 0;
+	std::uint64_t handChecksum = 0;
+	auto handSeconds = MeasureSeconds([&] {
+		std::string_view rest = input;
+		std::uint32_t token{};
+		for (; !rest.empty(); ++handTokens)
+		{
+			auto length = MatchByHand(rest, token);
+			handChecksum += token + length;
+			rest.remove_prefix(length);
+		}
+	});
+	PrintResult("lexer/hand-written", input.size(), handSeconds, static_cast<double>(input.size()));
+
+	if (tableTokens != handTokens || tableChecksum != handChecksum)
+	{
+		throw std::logic_error("Table-driven and hand-written lexers found different tokens");
+	}
+}
+
+std::uint64_t GetChecksum(std::span<const TransitionMatrix::Id> values) noexcept
+{
+	std::uint64_t result = 0;
+	for (auto value : values)
+	{
+		result = result * 0x100000001b3ULL + value + 1;
+	}
+	return result;
+}
+
+// Benchmarked runs are checked against the sequential one before they are timed
+void CheckResult(std::string_view benchmark, bool isSame)
+{
+	if (!isSame)
+	{
+		throw std::logic_error(std::string(benchmark) + " results differ from the sequential run");
+	}
+}
+
+// Every input shifts the state by input + 1, so paths from different states never meet:
+// the worst case of running chunks from all states
+MealyTable MakeCycleTable(size_t statesCount, size_t inputsCount)
+{
+	TransitionMatrix targets{ inputsCount, statesCount };
+	TransitionMatrix outputs{ inputsCount, statesCount };
+	for (size_t input = 0; input < inputsCount; ++input)
+	{
+		for (size_t state = 0; state < statesCount; ++state)
+		{
+			targets.At(input, state) = static_cast<TransitionMatrix::Id>((state + input + 1) % statesCount);
+			outputs.At(input, state) = static_cast<TransitionMatrix::Id>(state % SIMULATION_SIGNALS_COUNT);
+		}
+	}
+
+	return MealyTable{
+		SymbolTable::MakeIndexed('q', statesCount),
+		SymbolTable::MakeIndexed('z', inputsCount),
+		SymbolTable::MakeIndexed('w', SIMULATION_SIGNALS_COUNT),
+		targets,
+		outputs
+	};
+}
+
+// Sequential and parallel runs of one long input, returns the checksum of outputs
+std::uint64_t BenchLongInput(std::string_view benchmark, const MealyTable& table, std::span<const TransitionMatrix::Id> inputs)
+{
+	std::vector<TransitionMatrix::Id> outputs(inputs.size());
+	auto simulator = MealySimulator{ table };
+
+	TransitionMatrix::Id state{};
+	auto seconds = MeasureSeconds([&] { state = simulator.Run(0, inputs, outputs); });
+	PrintResult(benchmark, inputs.size(), seconds, static_cast<double>(inputs.size()));
+	auto checksum = GetChecksum(outputs);
+
+	auto parallelBenchmark = std::string(benchmark) + "-parallel";
+	std::fill(outputs.begin(), outputs.end(), 0);
+	auto parallelState = simulator.RunParallel(0, inputs, outputs, GetDefaultThreadsCount());
+	CheckResult(parallelBenchmark, parallelState == state && GetChecksum(outputs) == checksum);
+
+	auto parallelSeconds = MeasureSeconds([&] { simulator.RunParallel(0, inputs, outputs, GetDefaultThreadsCount()); });
+	PrintResult(parallelBenchmark, inputs.size(), parallelSeconds, static_cast<double>(inputs.size()));
+
+	return checksum;
+}
+
+std::vector<TransitionMatrix::Id> MakeRandomInputs(size_t size, size_t inputsCount, std::mt19937& random)
+{
+	std::vector<TransitionMatrix::Id> result(size);
+	for (auto& input : result)
+	{
+		input = static_cast<TransitionMatrix::Id>(random() % inputsCount);
+	}
+	return result;
+}
+
+void BenchSimulation()
+{
+	GeneratorParams params{};
+	params.m_statesCount = SIMULATION_STATES_COUNT;
+	params.m_inputsCount = SIMULATION_INPUTS_COUNT;
+	params.m_signalsCount = SIMULATION_SIGNALS_COUNT;
+	params.m_seed = SEED;
+	auto mealyTable = TableGenerator{ params }.MakeMealyTable();
+	std::mt19937 random{ SEED };
+	auto mooreTable = MooreTable{ mealyTable };
+	auto inputs = MakeRandomInputs(SIMULATION_INPUT_SIZE, SIMULATION_INPUTS_COUNT, random);
+	std::vector<TransitionMatrix::Id> outputs(inputs.size());
+
+	auto mealyChecksum = BenchLongInput("simulation/mealy", mealyTable, inputs);
+	BenchLongInput("simulation/mealy-cycle", MakeCycleTable(SIMULATION_CYCLE_STATES_COUNT, SIMULATION_INPUTS_COUNT), inputs);
+	auto mealySimulator = MealySimulator{ mealyTable };
+
+	// Moore table converted from Mealy one gives the same outputs from its first state
+	auto mooreSimulator = MooreSimulator{ mooreTable };
+	auto mooreSeconds = MeasureSeconds([&] { mooreSimulator.Run(0, inputs, outputs); });
+	CheckResult("simulation/moore", GetChecksum(outputs) == mealyChecksum);
+	PrintResult("simulation/moore", inputs.size(), mooreSeconds, static_cast<double>(inputs.size()));
+
+	// Ragged short streams: one by one against lockstep lanes
+	std::vector<TransitionMatrix::Id> offsets{ 0 };
+	for (size_t stream = 0; stream < BATCH_STREAMS_COUNT && offsets.back() < inputs.size(); ++stream)
+	{
+		offsets.push_back(static_cast<TransitionMatrix::Id>(std::min<size_t>(offsets.back() + 1 + random() % BATCH_MAX_STREAM_SIZE, inputs.size())));
+	}
+	std::span<const TransitionMatrix::Id> streamsInputs{ inputs.data(), offsets.back() };
+	std::vector<TransitionMatrix::Id> states(offsets.size() - 1);
+
+	auto singleSeconds = MeasureSeconds([&] {
+		for (size_t stream = 0; stream < states.size(); ++stream)
+		{
+			states[stream] = mealySimulator.Run(0,
+				streamsInputs.subspan(offsets[stream], offsets[stream + 1] - offsets[stream]),
+				std::span{ outputs }.subspan(offsets[stream]));
+		}
+	});
+	PrintResult("simulation/streams-one-by-one", streamsInputs.size(), singleSeconds, static_cast<double>(streamsInputs.size()));
+	auto singleStates = states;
+	auto singleChecksum = GetChecksum(std::span{ outputs }.first(streamsInputs.size()));
+
+	// Checks the path the bench is built with: AVX2 gathers or scalar lanes
+	auto batchSimulator = MealyBatchSimulator{ mealyTable };
+	std::fill(states.begin(), states.end(), 0);
+	std::fill(outputs.begin(), outputs.end(), 0);
+	batchSimulator.Run(streamsInputs, offsets, states, outputs);
+	CheckResult("simulation/streams-batch", states == singleStates
+		&& GetChecksum(std::span{ outputs }.first(streamsInputs.size())) == singleChecksum);
+
+	std::fill(states.begin(), states.end(), 0);
+	auto batchSeconds = MeasureSeconds([&] { batchSimulator.Run(streamsInputs, offsets, states, outputs); });
+	PrintResult("simulation/streams-batch", streamsInputs.size(), batchSeconds, static_cast<double>(streamsInputs.size()));
+}
+
+// Every stage of the command line tool on random tables, items are states of the source table
+void BenchTables(size_t statesCount)
+{
+	GeneratorParams params{};
+	params.m_statesCount = statesCount;
+	params.m_inputsCount = TABLES_INPUTS_COUNT;
+	params.m_signalsCount = TABLES_SIGNALS_COUNT;
+	params.m_reachableShare = TABLES_REACHABLE_SHARE;
+	params.m_seed = SEED;
+	auto generator = TableGenerator{ params };
+	auto mealyTable = generator.MakeMealyTable();
+	auto mooreTable = generator.MakeMooreTable();
+	auto items = static_cast<double>(statesCount);
+
+	std::ostringstream csv{};
+	auto writeSeconds = MeasureSeconds([&] { TableWriter{ csv }.Write(mealyTable); });
+	PrintResult("tables/mealy-write", statesCount, writeSeconds, items);
+
+	auto content = csv.str();
+	std::optional<MealyTable> readTable{};
+	auto readSeconds = MeasureSeconds([&] {
+		auto reader = MealyTableReader{ content };
+		readTable.emplace(reader.GetStates(), reader.GetTransitions(), reader.GetSignals(), reader.GetTargets(), reader.GetOutputs());
+	});
+	PrintResult("tables/mealy-read", statesCount, readSeconds, items);
+
+	std::ostringstream binary{};
+	auto writeBinarySeconds = MeasureSeconds([&] { BinaryTableWriter{ binary }.Write(mealyTable); });
+	PrintResult("tables/mealy-write-bin", statesCount, writeBinarySeconds, items);
+
+	content = binary.str();
+	auto readBinarySeconds = MeasureSeconds([&] { readTable.emplace(BinaryTableView{ content }.ToMealyTable()); });
+	PrintResult("tables/mealy-read-bin", statesCount, readBinarySeconds, items);
+
+	std::optional<MooreTable> convertedMoore{};
+	auto toMooreSeconds = MeasureSeconds([&] { convertedMoore.emplace(mealyTable); });
+	PrintResult("tables/mealy-to-moore", statesCount, toMooreSeconds, items);
+
+	std::optional<MealyTable> convertedMealy{};
+	auto toMealySeconds = MeasureSeconds([&] { convertedMealy.emplace(mooreTable); });
+	PrintResult("tables/moore-to-mealy", statesCount, toMealySeconds, items);
+
+	auto mealyMinimizeSeconds = MeasureSeconds([&] { mealyTable.Minimize(); });
+	PrintResult("tables/mealy-minimize", statesCount, mealyMinimizeSeconds, items);
+
+	auto mooreMinimizeSeconds = MeasureSeconds([&] { mooreTable.Minimize(); });
+	PrintResult("tables/moore-minimize", statesCount, mooreMinimizeSeconds, items);
+}
+
+} // namespace
+
+// Optional argument is the max states count of table benchmarks, 1000000 by default
+int main(int argc, char* argv[])
+{
+	try
+	{
+		auto maxStatesCount = argc > 1 ? std::stoull(argv[1]) : TABLES_MAX_STATES_COUNT;
+
+		std::cout << "benchmark;size;seconds;items_per_second" << std::endl;
+		BenchLexer();
+		BenchSimulation();
+		for (size_t statesCount = TABLES_MIN_STATES_COUNT; statesCount <= maxStatesCount; statesCount *= 10)
+		{
+			BenchTables(statesCount);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
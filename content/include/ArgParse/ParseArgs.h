@@ -8,6 +8,10 @@ constexpr auto MEALY_MIN = "mealy";
 constexpr auto MEALY_TO_MOORE = "mealy-to-moore";
 constexpr auto MOORE_MIN = "moore";
 constexpr auto MOORE_TO_MEALY = "moore-to-mealy";
+constexpr auto DETERMINIZE = "determinize";
+constexpr auto REGEX = "regex";
+constexpr auto MEALY_CODEGEN = "mealy-codegen";
+constexpr auto MOORE_CODEGEN = "moore-codegen";
 
 enum class ProgramMode
 {
@@ -15,6 +19,10 @@ enum class ProgramMode
 	MEALY_TO_MOORE,
 	MOORE_MIN,
 	MOORE_TO_MEALY,
+	DETERMINIZE,
+	REGEX,
+	MEALY_CODEGEN,
+	MOORE_CODEGEN,
 	UNKNOWN,
 };
 
@@ -36,11 +44,37 @@ inline ProgramMode StringToProgramMode(const std::string& str)
 	{
 		return ProgramMode::MOORE_TO_MEALY;
 	}
+	if (str == DETERMINIZE)
+	{
+		return ProgramMode::DETERMINIZE;
+	}
+	if (str == REGEX)
+	{
+		return ProgramMode::REGEX;
+	}
+	if (str == MEALY_CODEGEN)
+	{
+		return ProgramMode::MEALY_CODEGEN;
+	}
+	if (str == MOORE_CODEGEN)
+	{
+		return ProgramMode::MOORE_CODEGEN;
+	}
 	return ProgramMode::UNKNOWN;
 }
 
 constexpr auto INPUT_FILE_PAR = "<input-file>";
 constexpr auto OUTPUT_FILE_PAR = "<output-file>";
+constexpr auto THREADS_PAR = "--threads";
+constexpr auto OUT_FORMAT_PAR = "--out-format";
+constexpr auto CSV_FORMAT = "csv";
+constexpr auto BIN_FORMAT = "bin";
+constexpr auto STATS_PAR = "--stats";
+constexpr auto STATS_FILE_PAR = "--stats-file";
+constexpr auto BATCH_PAR = "--batch";
+constexpr auto BYTE_CLASSES_FILE_PAR = "--byte-classes-file";
+// Input or output file name that means stdin or stdout
+constexpr auto STD_STREAM_NAME = "-";
 
 argparse::ArgumentParser ParseArgs(int argc, char* argv[]);
 
@@ -0,0 +1,264 @@
+#ifndef AUTOMATA_BATCH_SIMULATOR_HPP_
+#define AUTOMATA_BATCH_SIMULATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "MealyMooreTable.hpp"
+
+namespace batch_simulator_excps
+{
+
+constexpr auto TOO_BIG_TABLE_MSG = "Failed to build batch simulator. Table cells count exceeds id range";
+constexpr auto WRONG_OFFSETS_MSG = "Failed to run streams. Offsets must grow from 0 to inputs size";
+constexpr auto WRONG_STATES_SIZE_MSG = "Failed to run streams. States count doesn't match streams count";
+constexpr auto WRONG_STATE_MSG = "Failed to run streams. Start state is out of range";
+constexpr auto WRONG_INPUT_MSG = "Failed to run streams. Input signal is out of range";
+constexpr auto SHORT_OUTPUTS_MSG = "Failed to run streams. Outputs are shorter than inputs";
+
+}; // namespace batch_simulator_excps
+
+// Runs one Mealy automaton over many independent streams in lockstep. LANES streams are advanced
+// together, and a lane whose stream is over takes the next one, so ragged lengths keep lanes busy.
+// With AVX2 a step of all lanes is three gathers over the flat targets and outputs; otherwise lanes
+// are stepped one after another, which still overlaps their loads.
+// Moore automata are run through MealyTable(const MooreTable&), which gives the same outputs
+class MealyBatchSimulator
+{
+public:
+	using Id = TransitionMatrix::Id;
+
+	static constexpr size_t LANES = 8;
+
+	explicit MealyBatchSimulator(const MealyTable& table)
+		: m_inputsCount(table.GetTransitions().GetSize())
+		, m_statesCount(table.GetStates().GetSize())
+		, m_targets(m_inputsCount * m_statesCount)
+		, m_outputs(m_inputsCount * m_statesCount)
+	{
+		if (m_targets.size() > static_cast<size_t>(std::numeric_limits<std::int32_t>::max()))
+		{
+			throw std::length_error(batch_simulator_excps::TOO_BIG_TABLE_MSG);
+		}
+
+		for (size_t state = 0; state < m_statesCount; ++state)
+		{
+			for (size_t input = 0; input < m_inputsCount; ++input)
+			{
+				m_targets[state * m_inputsCount + input] = static_cast<Id>(table.GetTargets().At(input, state) * m_inputsCount);
+				m_outputs[state * m_inputsCount + input] = table.GetOutputs().At(input, state);
+			}
+		}
+	}
+
+	// Streams are stored one after another: stream i is inputs[offsets[i]..offsets[i + 1]), its outputs
+	// are written at the same positions. states hold start state of every stream and receive the last one
+	void Run(std::span<const Id> inputs, std::span<const Id> offsets, std::span<Id> states, std::span<Id> outputs) const
+	{
+		CheckRun(inputs, offsets, states, outputs);
+		if (inputs.empty())
+		{
+			return;
+		}
+
+#if defined(__AVX2__)
+		if (inputs.size() <= static_cast<size_t>(std::numeric_limits<std::int32_t>::max()))
+		{
+			RunAvx2(inputs, offsets, states, outputs);
+			return;
+		}
+#endif
+		RunScalar(inputs, offsets, states, outputs);
+	}
+
+	size_t GetInputsCount() const noexcept
+	{
+		return m_inputsCount;
+	}
+
+	size_t GetStatesCount() const noexcept
+	{
+		return m_statesCount;
+	}
+
+private:
+	// Position and end of every lane's stream, its current row and index of the stream.
+	// Lanes without a stream have NO_STREAM and step 0, so they stay at position 0
+	struct Lanes
+	{
+		static constexpr Id NO_STREAM = std::numeric_limits<Id>::max();
+
+		alignas(32) std::array<Id, LANES> m_positions{};
+		alignas(32) std::array<Id, LANES> m_ends{};
+		alignas(32) std::array<Id, LANES> m_rows{};
+		alignas(32) std::array<Id, LANES> m_steps{};
+		std::array<Id, LANES> m_streams{};
+		size_t m_nextStream{};
+		size_t m_activeCount{};
+	};
+
+	void CheckRun(std::span<const Id> inputs, std::span<const Id> offsets, std::span<Id> states, std::span<Id> outputs) const
+	{
+		if (offsets.empty()
+			|| offsets.front() != 0
+			|| offsets.back() != inputs.size()
+			|| !std::is_sorted(offsets.begin(), offsets.end()))
+		{
+			throw std::invalid_argument(batch_simulator_excps::WRONG_OFFSETS_MSG);
+		}
+		if (states.size() + 1 != offsets.size())
+		{
+			throw std::invalid_argument(batch_simulator_excps::WRONG_STATES_SIZE_MSG);
+		}
+		if (outputs.size() < inputs.size())
+		{
+			throw std::invalid_argument(batch_simulator_excps::SHORT_OUTPUTS_MSG);
+		}
+		if (std::any_of(states.begin(), states.end(), [this](Id state) { return state >= m_statesCount; }))
+		{
+			throw std::out_of_range(batch_simulator_excps::WRONG_STATE_MSG);
+		}
+		if (!inputs.empty() && *std::max_element(inputs.begin(), inputs.end()) >= m_inputsCount)
+		{
+			throw std::out_of_range(batch_simulator_excps::WRONG_INPUT_MSG);
+		}
+	}
+
+	// Gives the lane the next non-empty stream, or leaves it idle
+	void Refill(Lanes& lanes, size_t lane, std::span<const Id> offsets, std::span<Id> states) const noexcept
+	{
+		const auto streamsCount = states.size();
+		while (lanes.m_nextStream < streamsCount && offsets[lanes.m_nextStream] == offsets[lanes.m_nextStream + 1])
+		{
+			++lanes.m_nextStream;
+		}
+
+		if (lanes.m_nextStream == streamsCount)
+		{
+			lanes.m_positions[lane] = 0;
+			lanes.m_ends[lane] = Lanes::NO_STREAM;
+			lanes.m_rows[lane] = 0;
+			lanes.m_steps[lane] = 0;
+			lanes.m_streams[lane] = Lanes::NO_STREAM;
+			return;
+		}
+
+		auto stream = lanes.m_nextStream++;
+		lanes.m_positions[lane] = offsets[stream];
+		lanes.m_ends[lane] = offsets[stream + 1];
+		lanes.m_rows[lane] = static_cast<Id>(states[stream] * m_inputsCount);
+		lanes.m_steps[lane] = 1;
+		lanes.m_streams[lane] = static_cast<Id>(stream);
+		++lanes.m_activeCount;
+	}
+
+	Lanes StartLanes(std::span<const Id> offsets, std::span<Id> states) const noexcept
+	{
+		Lanes lanes{};
+		for (size_t lane = 0; lane < LANES; ++lane)
+		{
+			Refill(lanes, lane, offsets, states);
+		}
+		return lanes;
+	}
+
+	// Saves the last state of the lane's finished stream and takes the next one
+	void FinishStream(Lanes& lanes, size_t lane, std::span<const Id> offsets, std::span<Id> states) const noexcept
+	{
+		states[lanes.m_streams[lane]] = static_cast<Id>(lanes.m_rows[lane] / m_inputsCount);
+		--lanes.m_activeCount;
+		Refill(lanes, lane, offsets, states);
+	}
+
+	void RunScalar(std::span<const Id> inputs, std::span<const Id> offsets, std::span<Id> states, std::span<Id> outputs) const
+	{
+		auto lanes = StartLanes(offsets, states);
+		while (lanes.m_activeCount != 0)
+		{
+			for (size_t lane = 0; lane < LANES; ++lane)
+			{
+				if (lanes.m_streams[lane] == Lanes::NO_STREAM)
+				{
+					continue;
+				}
+
+				auto position = lanes.m_positions[lane];
+				auto cell = lanes.m_rows[lane] + inputs[position];
+				lanes.m_rows[lane] = m_targets[cell];
+				outputs[position] = m_outputs[cell];
+				if (++lanes.m_positions[lane] == lanes.m_ends[lane])
+				{
+					FinishStream(lanes, lane, offsets, states);
+				}
+			}
+		}
+	}
+
+#if defined(__AVX2__)
+	void RunAvx2(std::span<const Id> inputs, std::span<const Id> offsets, std::span<Id> states, std::span<Id> outputs) const
+	{
+		auto inputsData = reinterpret_cast<const int*>(inputs.data());
+		auto targetsData = reinterpret_cast<const int*>(m_targets.data());
+		auto outputsData = reinterpret_cast<const int*>(m_outputs.data());
+
+		auto lanes = StartLanes(offsets, states);
+		auto positions = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.m_positions.data()));
+		auto ends = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.m_ends.data()));
+		auto rows = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.m_rows.data()));
+		auto steps = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.m_steps.data()));
+		alignas(32) std::array<Id, LANES> stepOutputs{};
+		while (lanes.m_activeCount != 0)
+		{
+			auto cells = _mm256_add_epi32(rows, _mm256_i32gather_epi32(inputsData, positions, 4));
+			rows = _mm256_i32gather_epi32(targetsData, cells, 4);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(stepOutputs.data()), _mm256_i32gather_epi32(outputsData, cells, 4));
+			_mm256_store_si256(reinterpret_cast<__m256i*>(lanes.m_positions.data()), positions);
+
+			for (size_t lane = 0; lane < LANES; ++lane)
+			{
+				if (lanes.m_streams[lane] != Lanes::NO_STREAM)
+				{
+					outputs[lanes.m_positions[lane]] = stepOutputs[lane];
+				}
+			}
+
+			positions = _mm256_add_epi32(positions, steps);
+			auto finished = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(positions, ends)));
+			if (finished == 0)
+			{
+				continue;
+			}
+
+			_mm256_store_si256(reinterpret_cast<__m256i*>(lanes.m_positions.data()), positions);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(lanes.m_rows.data()), rows);
+			for (size_t lane = 0; lane < LANES; ++lane)
+			{
+				if ((finished >> lane) & 1)
+				{
+					FinishStream(lanes, lane, offsets, states);
+				}
+			}
+			positions = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.m_positions.data()));
+			ends = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.m_ends.data()));
+			rows = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.m_rows.data()));
+			steps = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.m_steps.data()));
+		}
+	}
+#endif
+
+	size_t m_inputsCount;
+	size_t m_statesCount;
+	std::vector<Id> m_targets;
+	std::vector<Id> m_outputs;
+};
+
+#endif // !AUTOMATA_BATCH_SIMULATOR_HPP_
@@ -0,0 +1,439 @@
+#ifndef AUTOMATA_BINARY_TABLE_HPP_
+#define AUTOMATA_BINARY_TABLE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "MealyMooreTable.hpp"
+#include "State.hpp"
+
+namespace binary_table_excps
+{
+
+constexpr auto NOT_BINARY_TABLE_MSG = "Failed to read binary table. File doesn't start with binary table header";
+constexpr auto WRONG_VERSION_MSG = "Failed to read binary table. Unsupported format version";
+constexpr auto WRONG_BYTE_ORDER_MSG = "Failed to read binary table. Table was written with another byte order";
+constexpr auto WRONG_KIND_MSG = "Failed to read binary table. Table holds another kind of automaton";
+constexpr auto TRUNCATED_MSG = "Failed to read binary table. File size doesn't match its header";
+constexpr auto UNALIGNED_MSG = "Failed to read binary table. Content must be aligned to 8 bytes";
+constexpr auto WRONG_NAMES_MSG = "Failed to read binary table. Names section is corrupted";
+constexpr auto WRONG_CELL_MSG = "Failed to read binary table. Matrix contains id that is out of range";
+constexpr auto TOO_BIG_NAMES_MSG = "Failed to write binary table. Names take more than 4 GiB";
+constexpr auto FAILED_WRITE_MSG = "Failed to write binary table to output";
+
+}; // namespace binary_table_excps
+
+enum class BinaryTableKind : std::uint32_t
+{
+	MEALY = 0,
+	MOORE,
+};
+
+// File starts with this header, then go sections padded to 8 bytes:
+//   names of states, inputs and signals: (count + 1) uint32 offsets of names in chars, then chars;
+//   targets: inputs * states uint32, input-major as in TransitionMatrix;
+//   outputs: inputs * states uint32 for Mealy, states uint32 of state signals for Moore.
+// Numbers are in host byte order, a reader on another one refuses the file
+struct BinaryTableHeader
+{
+	static constexpr std::array<char, 4> MAGIC = { 'A', 'U', 'T', 'B' };
+	static constexpr std::uint32_t VERSION = 1;
+	static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+	std::array<char, 4> m_magic;
+	std::uint32_t m_version;
+	std::uint32_t m_byteOrder;
+	BinaryTableKind m_kind;
+	std::uint64_t m_statesCount;
+	std::uint64_t m_inputsCount;
+	std::uint64_t m_signalsCount;
+	std::uint64_t m_size;
+};
+
+inline bool IsBinaryTable(std::string_view content) noexcept
+{
+	return content.size() >= sizeof(BinaryTableHeader)
+		&& std::equal(BinaryTableHeader::MAGIC.begin(), BinaryTableHeader::MAGIC.end(), content.begin());
+}
+
+class BinaryTableWriter
+{
+public:
+	using Id = TransitionMatrix::Id;
+
+	explicit BinaryTableWriter(std::ostream& output)
+		: m_output(output)
+	{
+	}
+
+	void Write(const MealyTable& table)
+	{
+		const auto& targets = table.GetTargets().GetCells();
+		const auto& outputs = table.GetOutputs().GetCells();
+		auto header = MakeHeader(BinaryTableKind::MEALY, table.GetStates(), table.GetTransitions(), table.GetSignals());
+		header.m_size += GetCellsSize(targets.size()) + GetCellsSize(outputs.size());
+
+		WriteHeader(header, table.GetStates(), table.GetTransitions(), table.GetSignals());
+		WriteCells(targets);
+		WriteCells(outputs);
+		Flush();
+	}
+
+	void Write(const MooreTable& table)
+	{
+		const auto& targets = table.GetTargets().GetCells();
+		const auto& stateSignals = table.GetStateSignals();
+		auto header = MakeHeader(BinaryTableKind::MOORE, table.GetStates(), table.GetTransitions(), table.GetSignals());
+		header.m_size += GetCellsSize(targets.size()) + GetCellsSize(stateSignals.size());
+
+		WriteHeader(header, table.GetStates(), table.GetTransitions(), table.GetSignals());
+		WriteCells(targets);
+		WriteCells(stateSignals);
+		Flush();
+	}
+
+private:
+	static constexpr std::array<char, 8> PADDING{};
+
+	static size_t Pad(size_t size) noexcept
+	{
+		return (size + 7) & ~size_t{ 7 };
+	}
+
+	static size_t GetCellsSize(size_t count) noexcept
+	{
+		return Pad(count * sizeof(Id));
+	}
+
+	static size_t GetNamesSize(const SymbolTable& symbols)
+	{
+		size_t charsCount = 0;
+		for (auto& name : symbols.GetNames())
+		{
+			charsCount += name.size();
+		}
+		if (charsCount > std::numeric_limits<std::uint32_t>::max())
+		{
+			throw std::length_error(binary_table_excps::TOO_BIG_NAMES_MSG);
+		}
+
+		return Pad((symbols.GetSize() + 1) * sizeof(std::uint32_t) + charsCount);
+	}
+
+	static BinaryTableHeader MakeHeader(BinaryTableKind kind, const SymbolTable& states, const SymbolTable& transitions, const SymbolTable& signals)
+	{
+		return BinaryTableHeader{
+			BinaryTableHeader::MAGIC,
+			BinaryTableHeader::VERSION,
+			BinaryTableHeader::BYTE_ORDER_MARK,
+			kind,
+			states.GetSize(),
+			transitions.GetSize(),
+			signals.GetSize(),
+			sizeof(BinaryTableHeader) + GetNamesSize(states) + GetNamesSize(transitions) + GetNamesSize(signals)
+		};
+	}
+
+	void WriteHeader(const BinaryTableHeader& header, const SymbolTable& states, const SymbolTable& transitions, const SymbolTable& signals)
+	{
+		WriteBytes(&header, sizeof(header));
+		WriteNames(states);
+		WriteNames(transitions);
+		WriteNames(signals);
+	}
+
+	void WriteNames(const SymbolTable& symbols)
+	{
+		std::vector<std::uint32_t> offsets{ 0 };
+		offsets.reserve(symbols.GetSize() + 1);
+		for (auto& name : symbols.GetNames())
+		{
+			offsets.push_back(static_cast<std::uint32_t>(offsets.back() + name.size()));
+		}
+		WriteBytes(offsets.data(), offsets.size() * sizeof(std::uint32_t));
+		for (auto& name : symbols.GetNames())
+		{
+			WriteBytes(name.data(), name.size());
+		}
+		WritePadding(offsets.size() * sizeof(std::uint32_t) + offsets.back());
+	}
+
+	void WriteCells(const std::vector<Id>& cells)
+	{
+		WriteBytes(cells.data(), cells.size() * sizeof(Id));
+		WritePadding(cells.size() * sizeof(Id));
+	}
+
+	void WritePadding(size_t writtenSize)
+	{
+		WriteBytes(PADDING.data(), Pad(writtenSize) - writtenSize);
+	}
+
+	void WriteBytes(const void* data, size_t size)
+	{
+		m_output.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+	}
+
+	void Flush()
+	{
+		m_output.flush();
+		if (!m_output)
+		{
+			throw std::runtime_error(binary_table_excps::FAILED_WRITE_MSG);
+		}
+	}
+
+	std::ostream& m_output;
+};
+
+// Binary table used in place: names and matrices are views into the content, which must outlive the view.
+// Construction checks the layout and ranges of ids in matrices, nothing is parsed or copied
+class BinaryTableView
+{
+public:
+	using Id = TransitionMatrix::Id;
+
+	explicit BinaryTableView(std::string_view content)
+		: m_content(content)
+		, m_header()
+		, m_states()
+		, m_transitions()
+		, m_signals()
+		, m_targets()
+		, m_outputs()
+	{
+		ReadHeader();
+
+		size_t position = sizeof(BinaryTableHeader);
+		m_states = ReadNames(position, m_header.m_statesCount);
+		m_transitions = ReadNames(position, m_header.m_inputsCount);
+		m_signals = ReadNames(position, m_header.m_signalsCount);
+
+		if (m_header.m_inputsCount != 0 && m_header.m_statesCount > m_content.size() / m_header.m_inputsCount)
+		{
+			throw std::invalid_argument(binary_table_excps::TRUNCATED_MSG);
+		}
+		auto cellsCount = m_header.m_inputsCount * m_header.m_statesCount;
+		m_targets = ReadCells(position, cellsCount);
+		m_outputs = ReadCells(position, m_header.m_kind == BinaryTableKind::MEALY ? cellsCount : m_header.m_statesCount);
+		if (position != m_content.size())
+		{
+			throw std::invalid_argument(binary_table_excps::TRUNCATED_MSG);
+		}
+
+		CheckCells(m_targets, m_header.m_statesCount);
+		CheckCells(m_outputs, m_header.m_signalsCount);
+	}
+
+	BinaryTableKind GetKind() const noexcept
+	{
+		return m_header.m_kind;
+	}
+
+	size_t GetStatesCount() const noexcept
+	{
+		return m_header.m_statesCount;
+	}
+
+	size_t GetInputsCount() const noexcept
+	{
+		return m_header.m_inputsCount;
+	}
+
+	size_t GetSignalsCount() const noexcept
+	{
+		return m_header.m_signalsCount;
+	}
+
+	// Ids aren't checked, they must be less than the count of names of their kind
+	std::string_view GetStateName(Id state) const noexcept
+	{
+		return m_states.GetName(state);
+	}
+
+	std::string_view GetInputName(Id input) const noexcept
+	{
+		return m_transitions.GetName(input);
+	}
+
+	std::string_view GetSignalName(Id signal) const noexcept
+	{
+		return m_signals.GetName(signal);
+	}
+
+	// Input-major as in TransitionMatrix: the cell of (input, state) is at input * statesCount + state
+	std::span<const Id> GetTargets() const noexcept
+	{
+		return m_targets;
+	}
+
+	// Outputs of transitions for Mealy table, signals of states for Moore table
+	std::span<const Id> GetOutputs() const noexcept
+	{
+		return m_outputs;
+	}
+
+	MealyTable ToMealyTable() const
+	{
+		CheckKind(BinaryTableKind::MEALY);
+		return MealyTable{
+			m_states.ToSymbolTable(),
+			m_transitions.ToSymbolTable(),
+			m_signals.ToSymbolTable(),
+			ToMatrix(m_targets),
+			ToMatrix(m_outputs)
+		};
+	}
+
+	MooreTable ToMooreTable() const
+	{
+		CheckKind(BinaryTableKind::MOORE);
+		return MooreTable{
+			m_signals.ToSymbolTable(),
+			MooreTable::StateSignals(m_outputs.begin(), m_outputs.end()),
+			m_states.ToSymbolTable(),
+			m_transitions.ToSymbolTable(),
+			ToMatrix(m_targets)
+		};
+	}
+
+private:
+	struct Names
+	{
+		std::span<const std::uint32_t> m_offsets;
+		const char* m_chars;
+
+		std::string_view GetName(Id id) const noexcept
+		{
+			return { m_chars + m_offsets[id], m_offsets[id + 1] - m_offsets[id] };
+		}
+
+		SymbolTable ToSymbolTable() const
+		{
+			SymbolTable result{};
+			for (size_t id = 0; id + 1 < m_offsets.size(); ++id)
+			{
+				result.InternUnique(GetName(static_cast<Id>(id)));
+			}
+			return result;
+		}
+	};
+
+	void ReadHeader()
+	{
+		if (!IsBinaryTable(m_content))
+		{
+			throw std::invalid_argument(binary_table_excps::NOT_BINARY_TABLE_MSG);
+		}
+		if (reinterpret_cast<std::uintptr_t>(m_content.data()) % alignof(std::uint64_t) != 0)
+		{
+			throw std::invalid_argument(binary_table_excps::UNALIGNED_MSG);
+		}
+
+		std::memcpy(&m_header, m_content.data(), sizeof(m_header));
+		if (m_header.m_byteOrder != BinaryTableHeader::BYTE_ORDER_MARK)
+		{
+			throw std::invalid_argument(binary_table_excps::WRONG_BYTE_ORDER_MSG);
+		}
+		if (m_header.m_version != BinaryTableHeader::VERSION)
+		{
+			throw std::invalid_argument(binary_table_excps::WRONG_VERSION_MSG);
+		}
+		if (m_header.m_kind != BinaryTableKind::MEALY && m_header.m_kind != BinaryTableKind::MOORE)
+		{
+			throw std::invalid_argument(binary_table_excps::WRONG_KIND_MSG);
+		}
+		if (m_header.m_size != m_content.size()
+			|| m_header.m_statesCount > m_content.size()
+			|| m_header.m_inputsCount > m_content.size()
+			|| m_header.m_signalsCount > m_content.size())
+		{
+			throw std::invalid_argument(binary_table_excps::TRUNCATED_MSG);
+		}
+	}
+
+	// Section of count uint32 at the position, the position moves past its padding
+	std::span<const std::uint32_t> ReadCells(size_t& position, size_t count) const
+	{
+		if (count > (m_content.size() - position) / sizeof(std::uint32_t))
+		{
+			throw std::invalid_argument(binary_table_excps::TRUNCATED_MSG);
+		}
+		auto size = count * sizeof(std::uint32_t);
+
+		std::span<const std::uint32_t> result{ reinterpret_cast<const std::uint32_t*>(m_content.data() + position), count };
+		position = std::min(m_content.size(), position + ((size + 7) & ~size_t{ 7 }));
+
+		return result;
+	}
+
+	Names ReadNames(size_t& position, size_t count) const
+	{
+		auto start = position;
+		auto offsets = ReadCells(position, count + 1);
+		auto charsCount = size_t{ offsets.back() };
+		auto charsStart = start + offsets.size() * sizeof(std::uint32_t);
+		if (offsets.front() != 0
+			|| !std::is_sorted(offsets.begin(), offsets.end())
+			|| charsCount > m_content.size() - charsStart)
+		{
+			throw std::invalid_argument(binary_table_excps::WRONG_NAMES_MSG);
+		}
+		position = std::min(m_content.size(), start + ((offsets.size() * sizeof(std::uint32_t) + charsCount + 7) & ~size_t{ 7 }));
+
+		// Names are checked as the CSV readers check them: MooreTable and CodeWriter rely on it
+		auto names = Names{ offsets, m_content.data() + charsStart };
+		std::unordered_set<std::string_view> seenNames{};
+		seenNames.reserve(count);
+		for (size_t id = 0; id < count; ++id)
+		{
+			auto name = names.GetName(static_cast<Id>(id));
+			if (CheckSignalName(name) != StateParseError::NONE || !seenNames.insert(name).second)
+			{
+				throw std::invalid_argument(binary_table_excps::WRONG_NAMES_MSG);
+			}
+		}
+
+		return names;
+	}
+
+	static void CheckCells(std::span<const Id> cells, size_t idsCount)
+	{
+		if (!cells.empty() && *std::max_element(cells.begin(), cells.end()) >= idsCount)
+		{
+			throw std::out_of_range(binary_table_excps::WRONG_CELL_MSG);
+		}
+	}
+
+	void CheckKind(BinaryTableKind kind) const
+	{
+		if (m_header.m_kind != kind)
+		{
+			throw std::invalid_argument(binary_table_excps::WRONG_KIND_MSG);
+		}
+	}
+
+	TransitionMatrix ToMatrix(std::span<const Id> cells) const
+	{
+		return TransitionMatrix{ m_header.m_inputsCount, m_header.m_statesCount, TransitionMatrix::Cells(cells.begin(), cells.end()) };
+	}
+
+	std::string_view m_content;
+	BinaryTableHeader m_header;
+	Names m_states;
+	Names m_transitions;
+	Names m_signals;
+	std::span<const Id> m_targets;
+	std::span<const Id> m_outputs;
+};
+
+#endif // !AUTOMATA_BINARY_TABLE_HPP_
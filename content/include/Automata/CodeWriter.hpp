@@ -0,0 +1,244 @@
+#ifndef AUTOMATA_CODE_WRITER_HPP_
+#define AUTOMATA_CODE_WRITER_HPP_
+
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+
+#include "MealyMooreTable.hpp"
+
+namespace code_writer_excps
+{
+
+constexpr auto EMPTY_TABLE_MSG = "Failed to generate code. Table must have states and transitions";
+constexpr auto FAILED_WRITE_MSG = "Failed to write generated code to output";
+
+}; // namespace code_writer_excps
+
+// Writes a table as standalone C++ header with the automaton compiled into code. States, inputs and
+// signals become scoped enums named as in the table, Step is a switch over states and inputs, and
+// Run over a whole input sequence jumps between per-state blocks with plain goto, so every symbol
+// costs one switch on the input and no state is stored between steps
+class CodeWriter
+{
+public:
+	static constexpr auto NAMESPACE = "automaton";
+
+	explicit CodeWriter(std::ostream& output)
+		: m_output(output)
+	{
+	}
+
+	void Write(const MealyTable& table)
+	{
+		const auto& states = table.GetStates();
+		const auto& transitions = table.GetTransitions();
+		const auto& signals = table.GetSignals();
+		const auto& targets = table.GetTargets();
+		const auto& outputs = table.GetOutputs();
+		CheckTable(states, transitions);
+
+		WritePrologue("Mealy", states, transitions, signals);
+
+		m_output << "// Moves from the state by the input and gives the output signal of the transition\n"
+			<< "constexpr State Step(State state, Input input, Signal& output) noexcept\n"
+			<< "{\n"
+			<< "\tswitch (state)\n"
+			<< "\t{\n";
+		for (size_t state = 0; state < states.GetSize(); ++state)
+		{
+			m_output << "\tcase State::" << states.GetName(state) << ":\n"
+				<< "\t\tswitch (input)\n"
+				<< "\t\t{\n";
+			for (size_t input = 0; input < transitions.GetSize(); ++input)
+			{
+				m_output << "\t\tcase Input::" << transitions.GetName(input)
+					<< ": output = Signal::" << signals.GetName(outputs.At(input, state))
+					<< "; return State::" << states.GetName(targets.At(input, state)) << ";\n";
+			}
+			m_output << "\t\t}\n"
+				<< "\t\tbreak;\n";
+		}
+		m_output << "\t}\n"
+			<< "\treturn state;\n"
+			<< "}\n\n";
+
+		WriteRun("// Writes output signal of every step into outputs and returns the last state\n", states, transitions, targets, [&](size_t input, size_t state) {
+			return signals.GetName(outputs.At(input, state));
+		});
+
+		WriteEpilogue();
+	}
+
+	void Write(const MooreTable& table)
+	{
+		const auto& states = table.GetStates();
+		const auto& transitions = table.GetTransitions();
+		const auto& signals = table.GetSignals();
+		const auto& stateSignals = table.GetStateSignals();
+		const auto& targets = table.GetTargets();
+		CheckTable(states, transitions);
+
+		WritePrologue("Moore", states, transitions, signals);
+
+		m_output << "constexpr Signal GetOutput(State state) noexcept\n"
+			<< "{\n"
+			<< "\tswitch (state)\n"
+			<< "\t{\n";
+		for (size_t state = 0; state < states.GetSize(); ++state)
+		{
+			m_output << "\tcase State::" << states.GetName(state)
+				<< ": return Signal::" << signals.GetName(stateSignals[state]) << ";\n";
+		}
+		m_output << "\t}\n"
+			<< "\treturn Signal{};\n"
+			<< "}\n\n";
+
+		m_output << "constexpr State Step(State state, Input input) noexcept\n"
+			<< "{\n"
+			<< "\tswitch (state)\n"
+			<< "\t{\n";
+		for (size_t state = 0; state < states.GetSize(); ++state)
+		{
+			m_output << "\tcase State::" << states.GetName(state) << ":\n"
+				<< "\t\tswitch (input)\n"
+				<< "\t\t{\n";
+			for (size_t input = 0; input < transitions.GetSize(); ++input)
+			{
+				m_output << "\t\tcase Input::" << transitions.GetName(input)
+					<< ": return State::" << states.GetName(targets.At(input, state)) << ";\n";
+			}
+			m_output << "\t\t}\n"
+				<< "\t\tbreak;\n";
+		}
+		m_output << "\t}\n"
+			<< "\treturn state;\n"
+			<< "}\n\n";
+
+		WriteRun("// Writes output signal of the state entered by every step into outputs and returns the last state\n", states, transitions, targets, [&](size_t input, size_t state) {
+			return signals.GetName(stateSignals[targets.At(input, state)]);
+		});
+
+		WriteEpilogue();
+	}
+
+private:
+	static void CheckTable(const SymbolTable& states, const SymbolTable& transitions)
+	{
+		if (states.IsEmpty() || transitions.IsEmpty())
+		{
+			throw std::invalid_argument(code_writer_excps::EMPTY_TABLE_MSG);
+		}
+	}
+
+	// Names are checked by CheckSignalName when tables are read, so they are valid identifiers
+	void WriteEnum(std::string_view name, const SymbolTable& symbols)
+	{
+		m_output << "enum class " << name << " : std::uint32_t\n"
+			<< "{\n";
+		for (auto& symbol : symbols.GetNames())
+		{
+			m_output << '\t' << symbol << ",\n";
+		}
+		m_output << "};\n\n";
+	}
+
+	void WriteNames(std::string_view name, const SymbolTable& symbols)
+	{
+		m_output << "constexpr const char* " << name << "[] = { ";
+		for (size_t i = 0; i < symbols.GetSize(); ++i)
+		{
+			m_output << (i == 0 ? "\"" : ", \"") << symbols.GetName(i) << '"';
+		}
+		m_output << " };\n";
+	}
+
+	void WritePrologue(std::string_view kind, const SymbolTable& states, const SymbolTable& transitions, const SymbolTable& signals)
+	{
+		m_output << "// Generated by automata from a " << kind << " table. Do not edit\n"
+			<< "#pragma once\n\n"
+			<< "#include <cstddef>\n"
+			<< "#include <cstdint>\n\n"
+			<< "// Switches cover all enumerators, so they have no default\n"
+			<< "#if defined(__GNUC__)\n"
+			<< "#pragma GCC diagnostic push\n"
+			<< "#pragma GCC diagnostic ignored \"-Wswitch-default\"\n"
+			<< "#endif\n\n"
+			<< "namespace " << NAMESPACE << "\n"
+			<< "{\n\n";
+
+		WriteEnum("State", states);
+		WriteEnum("Input", transitions);
+		WriteEnum("Signal", signals);
+
+		m_output << "constexpr std::size_t STATES_COUNT = " << states.GetSize() << ";\n"
+			<< "constexpr std::size_t INPUTS_COUNT = " << transitions.GetSize() << ";\n"
+			<< "constexpr std::size_t SIGNALS_COUNT = " << signals.GetSize() << ";\n\n";
+
+		WriteNames("STATE_NAMES", states);
+		WriteNames("INPUT_NAMES", transitions);
+		WriteNames("SIGNAL_NAMES", signals);
+		m_output << '\n';
+	}
+
+	// Run jumps once to the block of the start state, then blocks jump straight to each other.
+	// getSignal(input, state) is the name of the output signal of the transition
+	template <typename GetSignal>
+	void WriteRun(std::string_view comment,
+		const SymbolTable& states,
+		const SymbolTable& transitions,
+		const TransitionMatrix& targets,
+		GetSignal&& getSignal)
+	{
+		m_output << comment
+			<< "inline State Run(State state, const Input* inputs, std::size_t size, Signal* outputs) noexcept\n"
+			<< "{\n"
+			<< "\tstd::size_t i = 0;\n"
+			<< "\tswitch (state)\n"
+			<< "\t{\n";
+		for (size_t state = 0; state < states.GetSize(); ++state)
+		{
+			m_output << "\tcase State::" << states.GetName(state) << ": goto STATE_" << states.GetName(state) << ";\n";
+		}
+		m_output << "\t}\n"
+			<< "\treturn state;\n";
+
+		for (size_t state = 0; state < states.GetSize(); ++state)
+		{
+			m_output << "STATE_" << states.GetName(state) << ":\n"
+				<< "\tif (i == size)\n"
+				<< "\t{\n"
+				<< "\t\treturn State::" << states.GetName(state) << ";\n"
+				<< "\t}\n"
+				<< "\tswitch (inputs[i])\n"
+				<< "\t{\n";
+			for (size_t input = 0; input < transitions.GetSize(); ++input)
+			{
+				m_output << "\tcase Input::" << transitions.GetName(input)
+					<< ": outputs[i++] = Signal::" << getSignal(input, state)
+					<< "; goto STATE_" << states.GetName(targets.At(input, state)) << ";\n";
+			}
+			m_output << "\t}\n"
+				<< "\treturn State::" << states.GetName(state) << ";\n";
+		}
+		m_output << "}\n";
+	}
+
+	void WriteEpilogue()
+	{
+		m_output << "\n} // namespace " << NAMESPACE << "\n\n"
+			<< "#if defined(__GNUC__)\n"
+			<< "#pragma GCC diagnostic pop\n"
+			<< "#endif\n";
+
+		m_output.flush();
+		if (!m_output)
+		{
+			throw std::runtime_error(code_writer_excps::FAILED_WRITE_MSG);
+		}
+	}
+
+	std::ostream& m_output;
+};
+
+#endif // !AUTOMATA_CODE_WRITER_HPP_
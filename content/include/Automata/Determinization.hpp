@@ -0,0 +1,547 @@
+#ifndef AUTOMATA_DETERMINIZATION_HPP_
+#define AUTOMATA_DETERMINIZATION_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "MealyMooreTable.hpp"
+#include "NfaTable.hpp"
+#include "Parallel.hpp"
+#include "SymbolTable.hpp"
+#include "TransitionMatrix.hpp"
+
+namespace determinization_excps
+{
+
+constexpr auto EMPTY_NFA_MSG = "Failed to determinize NFA. NFA has no start state";
+constexpr auto TOO_MANY_SUBSETS_MSG = "Failed to determinize NFA. DFA states count exceeds id range";
+
+}; // namespace determinization_excps
+
+// Subset construction. Sets of NFA states are bitsets of equal width stored one after another,
+// deduplicated with an open addressing table of their hashes. Epsilon closures are computed once:
+// for every (input, state) the closure of its targets is cached, so a step of a subset is a union
+// of cached lists. DFA state i is the i-th discovered subset, the start subset is 0.
+// The empty subset, if reached, becomes an ordinary sink state.
+// With several threads subsets of one BFS frontier are expanded in parallel and deduplicated
+// in a table split into stripes with own locks. Discovered subsets are numbered in BFS order
+// at the end, so the result doesn't depend on threads count
+class SubsetConstruction
+{
+public:
+	using Id = SymbolTable::Id;
+	using Word = std::uint64_t;
+	using AcceptTags = NfaTable::AcceptTags;
+
+	static constexpr size_t WORD_BITS = 64;
+	static constexpr size_t STRIPES_COUNT = 64;
+	// Frontiers smaller than this are expanded on the calling thread
+	static constexpr size_t MIN_PARALLEL_FRONTIER = 64;
+
+	explicit SubsetConstruction(const NfaTable& nfa, size_t threadsCount = 1)
+		: m_nfaStatesCount(nfa.GetStates().GetSize())
+		, m_inputsCount(nfa.GetTransitions().GetSize())
+		, m_wordsCount((m_nfaStatesCount + WORD_BITS - 1) / WORD_BITS)
+	{
+		if (m_nfaStatesCount == 0)
+		{
+			throw std::invalid_argument(determinization_excps::EMPTY_NFA_MSG);
+		}
+
+		BuildClosures(nfa);
+		if (threadsCount > 1)
+		{
+			RunParallel(nfa.GetAcceptTags(), threadsCount);
+		}
+		else
+		{
+			Run(nfa.GetAcceptTags());
+		}
+	}
+
+	size_t GetSubsetsCount() const noexcept
+	{
+		return m_acceptTags.size();
+	}
+
+	// Dense DFA transitions by NFA inputs
+	const TransitionMatrix& GetTargets() const noexcept
+	{
+		return m_targets;
+	}
+
+	// Accept tag of every DFA state: the highest priority tag of its NFA states
+	const AcceptTags& GetAcceptTags() const noexcept
+	{
+		return m_acceptTags;
+	}
+
+private:
+	static constexpr Id EMPTY_SLOT = std::numeric_limits<Id>::max();
+
+	// Subset met during parallel construction. Words of subsets found in the current frontier
+	// are kept by the thread that found them until the frontier is over
+	struct StripeEntry
+	{
+		std::uint64_t m_hash;
+		Id m_subset;
+		const Word* m_words;
+	};
+
+	struct Stripe
+	{
+		std::mutex m_mutex;
+		std::vector<StripeEntry> m_entries;
+		size_t m_size{};
+	};
+
+	// Storage of words that never moves already allocated subsets
+	class WordsArena
+	{
+	public:
+		static constexpr size_t BLOCK_WORDS = 1 << 16;
+
+		Word* Allocate(size_t count)
+		{
+			if (m_blocks.empty() || m_used + count > m_blockSize)
+			{
+				m_blockSize = std::max(BLOCK_WORDS, count);
+				m_blocks.push_back(std::make_unique<Word[]>(m_blockSize));
+				m_used = 0;
+			}
+			auto result = m_blocks.back().get() + m_used;
+			m_used += count;
+			return result;
+		}
+
+		void Clear() noexcept
+		{
+			m_blocks.clear();
+			m_used = 0;
+		}
+
+	private:
+		std::vector<std::unique_ptr<Word[]>> m_blocks;
+		size_t m_blockSize{};
+		size_t m_used{};
+	};
+
+	struct FoundSubset
+	{
+		Id m_subset;
+		const Word* m_words;
+	};
+
+	// States reached from the state with epsilon transitions, including itself
+	void CollectClosure(const NfaTargets& epsilonTargets, Id state, Id stamp, std::vector<Id>& stamps, std::vector<Id>& result)
+	{
+		std::vector<Id> stack{ state };
+		stamps[state] = stamp;
+		while (!stack.empty())
+		{
+			auto current = stack.back();
+			stack.pop_back();
+			result.push_back(current);
+			for (auto target : epsilonTargets.At(0, current))
+			{
+				if (stamps[target] != stamp)
+				{
+					stamps[target] = stamp;
+					stack.push_back(target);
+				}
+			}
+		}
+	}
+
+	void BuildClosures(const NfaTable& nfa)
+	{
+		std::vector<Id> stamps(m_nfaStatesCount, EMPTY_SLOT);
+		Id stamp = 0;
+
+		std::vector<Id> closureOffsets{ 0 };
+		std::vector<Id> closures{};
+		for (Id state = 0; state < m_nfaStatesCount; ++state, ++stamp)
+		{
+			CollectClosure(nfa.GetEpsilonTargets(), state, stamp, stamps, closures);
+			closureOffsets.push_back(static_cast<Id>(closures.size()));
+		}
+		m_startClosure.assign(closures.begin(), closures.begin() + closureOffsets[1]);
+
+		std::fill(stamps.begin(), stamps.end(), EMPTY_SLOT);
+		stamp = 0;
+		m_stepOffsets.assign(1, 0);
+		for (size_t input = 0; input < m_inputsCount; ++input)
+		{
+			for (size_t state = 0; state < m_nfaStatesCount; ++state, ++stamp)
+			{
+				for (auto target : nfa.GetTargets().At(input, state))
+				{
+					for (auto i = closureOffsets[target]; i < closureOffsets[target + 1]; ++i)
+					{
+						if (stamps[closures[i]] != stamp)
+						{
+							stamps[closures[i]] = stamp;
+							m_stepStates.push_back(closures[i]);
+						}
+					}
+				}
+				m_stepOffsets.push_back(static_cast<Id>(m_stepStates.size()));
+			}
+		}
+	}
+
+	static std::uint64_t HashWords(const Word* words, size_t count) noexcept
+	{
+		std::uint64_t hash = count;
+		for (size_t i = 0; i < count; ++i)
+		{
+			hash ^= words[i] + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+			hash *= 0xbf58476d1ce4e5b9ULL;
+		}
+		return hash ^ (hash >> 31);
+	}
+
+	const Word* GetSubset(Id subset) const noexcept
+	{
+		return m_subsets.data() + size_t{ subset } * m_wordsCount;
+	}
+
+	// Union of cached closures of targets of all subset's states by the input
+	void ComputeStep(Id subset, size_t input, Word* result) const noexcept
+	{
+		std::fill(result, result + m_wordsCount, Word{});
+		auto words = GetSubset(subset);
+		for (size_t wordIndex = 0; wordIndex < m_wordsCount; ++wordIndex)
+		{
+			for (auto word = words[wordIndex]; word != 0; word &= word - 1)
+			{
+				auto cell = input * m_nfaStatesCount + wordIndex * WORD_BITS + std::countr_zero(word);
+				for (auto i = m_stepOffsets[cell]; i < m_stepOffsets[cell + 1]; ++i)
+				{
+					auto state = m_stepStates[i];
+					result[state / WORD_BITS] |= Word{ 1 } << (state % WORD_BITS);
+				}
+			}
+		}
+	}
+
+	std::uint32_t GetAcceptTag(const Word* words, const AcceptTags& nfaAcceptTags) const noexcept
+	{
+		std::uint32_t result = 0;
+		for (size_t wordIndex = 0; wordIndex < m_wordsCount; ++wordIndex)
+		{
+			for (auto word = words[wordIndex]; word != 0; word &= word - 1)
+			{
+				auto tag = nfaAcceptTags[wordIndex * WORD_BITS + std::countr_zero(word)];
+				if (tag != 0 && (result == 0 || tag < result))
+				{
+					result = tag;
+				}
+			}
+		}
+		return result;
+	}
+
+	void GrowSlots()
+	{
+		std::vector<Id> slots(std::max<size_t>(16, m_slots.size() * 2), EMPTY_SLOT);
+		const auto mask = slots.size() - 1;
+		for (Id subset = 0; subset < m_subsetsHashes.size(); ++subset)
+		{
+			auto slot = m_subsetsHashes[subset] & mask;
+			while (slots[slot] != EMPTY_SLOT)
+			{
+				slot = (slot + 1) & mask;
+			}
+			slots[slot] = subset;
+		}
+		m_slots = std::move(slots);
+	}
+
+	Id FindOrInsert(const Word* words, const AcceptTags& nfaAcceptTags)
+	{
+		if ((m_subsetsHashes.size() + 1) * 2 > m_slots.size())
+		{
+			GrowSlots();
+		}
+
+		const auto hash = HashWords(words, m_wordsCount);
+		const auto mask = m_slots.size() - 1;
+		for (auto slot = hash & mask;; slot = (slot + 1) & mask)
+		{
+			auto subset = m_slots[slot];
+			if (subset == EMPTY_SLOT)
+			{
+				if (m_subsetsHashes.size() >= EMPTY_SLOT)
+				{
+					throw std::length_error(determinization_excps::TOO_MANY_SUBSETS_MSG);
+				}
+				subset = static_cast<Id>(m_subsetsHashes.size());
+				m_slots[slot] = subset;
+				m_subsetsHashes.push_back(hash);
+				m_subsets.insert(m_subsets.end(), words, words + m_wordsCount);
+				m_acceptTags.push_back(GetAcceptTag(words, nfaAcceptTags));
+				return subset;
+			}
+			if (m_subsetsHashes[subset] == hash && std::equal(words, words + m_wordsCount, GetSubset(subset)))
+			{
+				return subset;
+			}
+		}
+	}
+
+	void Run(const AcceptTags& nfaAcceptTags)
+	{
+		std::vector<Word> step(m_wordsCount);
+		for (auto state : m_startClosure)
+		{
+			step[state / WORD_BITS] |= Word{ 1 } << (state % WORD_BITS);
+		}
+		FindOrInsert(step.data(), nfaAcceptTags);
+
+		// Rows are collected per subset and transposed into the input-major matrix at the end
+		std::vector<Id> subsetsTargets{};
+		for (Id subset = 0; subset < m_subsetsHashes.size(); ++subset)
+		{
+			for (size_t input = 0; input < m_inputsCount; ++input)
+			{
+				ComputeStep(subset, input, step.data());
+				subsetsTargets.push_back(FindOrInsert(step.data(), nfaAcceptTags));
+			}
+		}
+
+		BuildTargets(subsetsTargets, m_subsetsHashes.size());
+	}
+
+	void BuildTargets(const std::vector<Id>& subsetsTargets, size_t subsetsCount)
+	{
+		m_targets = TransitionMatrix{ m_inputsCount, subsetsCount };
+		for (size_t subset = 0; subset < subsetsCount; ++subset)
+		{
+			for (size_t input = 0; input < m_inputsCount; ++input)
+			{
+				m_targets.At(input, subset) = subsetsTargets[subset * m_inputsCount + input];
+			}
+		}
+	}
+
+	const Word* GetSubsetWords(const StripeEntry& entry, Id committedCount) const noexcept
+	{
+		return entry.m_subset < committedCount ? GetSubset(entry.m_subset) : entry.m_words;
+	}
+
+	// Id of the subset, which is added with the next free id when it's met for the first time.
+	// Subsets with ids below committedCount are already moved to m_subsets
+	Id FindOrInsertConcurrent(std::vector<Stripe>& stripes,
+		const Word* words,
+		Id committedCount,
+		std::atomic<Id>& nextSubset,
+		WordsArena& arena,
+		std::vector<FoundSubset>& found)
+	{
+		const auto hash = HashWords(words, m_wordsCount);
+		auto& stripe = stripes[(hash >> 58) & (STRIPES_COUNT - 1)];
+		std::lock_guard lock{ stripe.m_mutex };
+
+		if ((stripe.m_size + 1) * 2 > stripe.m_entries.size())
+		{
+			std::vector<StripeEntry> entries(std::max<size_t>(16, stripe.m_entries.size() * 2), StripeEntry{ 0, EMPTY_SLOT, nullptr });
+			const auto mask = entries.size() - 1;
+			for (auto& entry : stripe.m_entries)
+			{
+				if (entry.m_subset != EMPTY_SLOT)
+				{
+					auto slot = entry.m_hash & mask;
+					while (entries[slot].m_subset != EMPTY_SLOT)
+					{
+						slot = (slot + 1) & mask;
+					}
+					entries[slot] = entry;
+				}
+			}
+			stripe.m_entries = std::move(entries);
+		}
+
+		const auto mask = stripe.m_entries.size() - 1;
+		for (auto slot = hash & mask;; slot = (slot + 1) & mask)
+		{
+			auto& entry = stripe.m_entries[slot];
+			if (entry.m_subset == EMPTY_SLOT)
+			{
+				auto subset = nextSubset.fetch_add(1);
+				if (subset == EMPTY_SLOT)
+				{
+					throw std::length_error(determinization_excps::TOO_MANY_SUBSETS_MSG);
+				}
+
+				auto stored = arena.Allocate(m_wordsCount);
+				std::copy(words, words + m_wordsCount, stored);
+				entry = StripeEntry{ hash, subset, stored };
+				++stripe.m_size;
+				found.push_back(FoundSubset{ subset, stored });
+				return subset;
+			}
+			if (entry.m_hash == hash && std::equal(words, words + m_wordsCount, GetSubsetWords(entry, committedCount)))
+			{
+				return entry.m_subset;
+			}
+		}
+	}
+
+	void RunParallel(const AcceptTags& nfaAcceptTags, size_t threadsCount)
+	{
+		// Deep NFAs give thousands of frontiers, so all of them run on one pool of threads
+		WorkerPool pool{ threadsCount };
+		std::vector<Stripe> stripes(STRIPES_COUNT);
+		std::vector<WordsArena> arenas(threadsCount);
+		std::vector<std::vector<FoundSubset>> found(threadsCount);
+		std::atomic<Id> nextSubset{ 0 };
+
+		std::vector<Word> start(m_wordsCount);
+		for (auto state : m_startClosure)
+		{
+			start[state / WORD_BITS] |= Word{ 1 } << (state % WORD_BITS);
+		}
+		FindOrInsertConcurrent(stripes, start.data(), 0, nextSubset, arenas[0], found[0]);
+
+		std::vector<Id> subsetsTargets{};
+		Id frontierBegin = 0;
+		for (;;)
+		{
+			// Subsets found by the last frontier are moved to m_subsets, they form the next frontier
+			const Id frontierEnd = nextSubset.load();
+			m_subsets.resize(size_t{ frontierEnd } * m_wordsCount);
+			for (size_t range = 0; range < threadsCount; ++range)
+			{
+				for (auto& subset : found[range])
+				{
+					std::copy(subset.m_words, subset.m_words + m_wordsCount, m_subsets.data() + size_t{ subset.m_subset } * m_wordsCount);
+				}
+				found[range].clear();
+				arenas[range].Clear();
+			}
+			if (frontierBegin == frontierEnd)
+			{
+				break;
+			}
+
+			subsetsTargets.resize(size_t{ frontierEnd } * m_inputsCount);
+			const size_t frontierSize = frontierEnd - frontierBegin;
+			auto expand = [&](size_t begin, size_t end, size_t rangeIndex) {
+				std::vector<Word> step(m_wordsCount);
+				for (auto i = begin; i < end; ++i)
+				{
+					auto subset = static_cast<Id>(frontierBegin + i);
+					for (size_t input = 0; input < m_inputsCount; ++input)
+					{
+						ComputeStep(subset, input, step.data());
+						subsetsTargets[size_t{ subset } * m_inputsCount + input] = FindOrInsertConcurrent(stripes,
+							step.data(), frontierEnd, nextSubset, arenas[rangeIndex], found[rangeIndex]);
+					}
+				}
+			};
+			if (frontierSize < MIN_PARALLEL_FRONTIER)
+			{
+				expand(0, frontierSize, 0);
+			}
+			else
+			{
+				pool.Run(frontierSize, expand);
+			}
+			frontierBegin = frontierEnd;
+		}
+
+		RenumberInBfsOrder(pool, subsetsTargets, nfaAcceptTags);
+	}
+
+	// Renumbers subsets in order of their discovery by BFS over inputs in order, as the sequential run does
+	void RenumberInBfsOrder(WorkerPool& pool, const std::vector<Id>& subsetsTargets, const AcceptTags& nfaAcceptTags)
+	{
+		const auto subsetsCount = subsetsTargets.size() / std::max<size_t>(1, m_inputsCount);
+		const auto count = m_inputsCount == 0 ? size_t{ 1 } : subsetsCount;
+
+		std::vector<Id> newIds(count, EMPTY_SLOT);
+		std::vector<Id> order{ 0 };
+		order.reserve(count);
+		newIds[0] = 0;
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			for (size_t input = 0; input < m_inputsCount; ++input)
+			{
+				auto target = subsetsTargets[size_t{ order[i] } * m_inputsCount + input];
+				if (newIds[target] == EMPTY_SLOT)
+				{
+					newIds[target] = static_cast<Id>(order.size());
+					order.push_back(target);
+				}
+			}
+		}
+
+		std::vector<Id> renumberedTargets(count * m_inputsCount);
+		m_acceptTags.resize(count);
+		pool.Run(count, [&](size_t begin, size_t end, size_t) {
+			for (auto newId = begin; newId < end; ++newId)
+			{
+				auto oldId = order[newId];
+				m_acceptTags[newId] = GetAcceptTag(GetSubset(oldId), nfaAcceptTags);
+				for (size_t input = 0; input < m_inputsCount; ++input)
+				{
+					renumberedTargets[newId * m_inputsCount + input] = newIds[subsetsTargets[size_t{ oldId } * m_inputsCount + input]];
+				}
+			}
+		});
+
+		BuildTargets(renumberedTargets, count);
+	}
+
+	size_t m_nfaStatesCount;
+	size_t m_inputsCount;
+	size_t m_wordsCount;
+
+	std::vector<Id> m_startClosure{};
+	std::vector<Id> m_stepOffsets{};
+	std::vector<Id> m_stepStates{};
+
+	std::vector<Word> m_subsets{};
+	std::vector<std::uint64_t> m_subsetsHashes{};
+	std::vector<Id> m_slots{};
+
+	AcceptTags m_acceptTags{};
+	TransitionMatrix m_targets{};
+};
+
+// Output signal of determinized automaton's state is y<accept tag>, so rejecting states give y0
+constexpr char ACCEPT_SIGNALS_LABEL = 'y';
+constexpr char DFA_STATES_LABEL = 'S';
+
+// Moore automaton equivalent to NFA
+inline MooreTable Determinize(const NfaTable& nfa, size_t threadsCount = 1)
+{
+	auto construction = SubsetConstruction{ nfa, threadsCount };
+
+	SymbolTable signals{};
+	MooreTable::StateSignals stateSignals{};
+	stateSignals.reserve(construction.GetSubsetsCount());
+	for (auto tag : construction.GetAcceptTags())
+	{
+		stateSignals.push_back(signals.Intern(ACCEPT_SIGNALS_LABEL + std::to_string(tag)));
+	}
+
+	return MooreTable{
+		signals,
+		stateSignals,
+		SymbolTable::MakeIndexed(DFA_STATES_LABEL, construction.GetSubsetsCount()),
+		nfa.GetTransitions(),
+		construction.GetTargets()
+	};
+}
+
+#endif // !AUTOMATA_DETERMINIZATION_HPP_
@@ -0,0 +1,299 @@
+#ifndef AUTOMATA_LEXER_HPP_
+#define AUTOMATA_LEXER_HPP_
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Determinization.hpp"
+#include "MealyMooreTable.hpp"
+#include "Regex.hpp"
+#include "State.hpp"
+
+namespace lexer_excps
+{
+
+constexpr auto NO_RULES_MSG = "Failed to build lexer. Lexer must have at least one rule";
+constexpr auto EMPTY_TABLE_MSG = "Failed to build lexer. Table has no start state";
+constexpr auto WRONG_BYTE_CLASS_MSG = "Failed to build lexer. Byte class is out of table's inputs";
+constexpr auto WRONG_OUTPUT_MSG = "Failed to build lexer. Output signal must be y<rule index + 1>, got ";
+
+}; // namespace lexer_excps
+
+// Rule index of the longest prefix, or LexerTable::NO_TOKEN for a byte that starts no token
+struct Token
+{
+	std::uint32_t m_id;
+	std::string_view m_text;
+};
+
+// DFA of all lexer rules laid out for scanning. Every state is a row of targets by byte classes followed
+// by the state's token, and targets are stored as offsets of their rows, so one step of scanning is
+// a byte class lookup and a single load. Rows of accepting states go first, so a state is checked
+// for a token by comparing its offset. States that can't reach any token are merged into the last, dead row
+class LexerTable
+{
+public:
+	using Id = std::uint32_t;
+	using ByteClasses = RegexCompiler::ByteClasses;
+	using Rules = std::vector<std::string_view>;
+
+	static constexpr Id NO_TOKEN = std::numeric_limits<Id>::max();
+
+	// Token of a rule is its index. When several rules match the longest prefix the first of them wins
+	explicit LexerTable(const Rules& rules, size_t threadsCount = 1)
+		: LexerTable(CompileRules(rules, threadsCount))
+	{
+	}
+
+	// Moore automaton with start state 0, inputs of byte classes and outputs y<rule index + 1>, y0 for no token
+	LexerTable(const MooreTable& table, const ByteClasses& byteClasses)
+		: m_byteClasses(byteClasses)
+		, m_classesCount(table.GetTransitions().GetSize())
+		, m_rowSize(m_classesCount + 1)
+		, m_rows()
+		, m_startRow()
+		, m_acceptingRowsEnd()
+		, m_deadRow(NO_ROW)
+	{
+		if (table.GetStates().IsEmpty())
+		{
+			throw std::invalid_argument(lexer_excps::EMPTY_TABLE_MSG);
+		}
+		for (auto byteClass : m_byteClasses)
+		{
+			if (byteClass >= m_classesCount)
+			{
+				throw std::invalid_argument(lexer_excps::WRONG_BYTE_CLASS_MSG);
+			}
+		}
+		BuildRows(table);
+	}
+
+	// Length of the longest non-empty prefix matched by rules and its token, {0, NO_TOKEN} if there is none
+	std::pair<size_t, Id> Match(std::string_view text) const noexcept
+	{
+		auto rows = m_rows.data();
+		size_t lastLength = 0;
+		Id lastRow = NO_ROW;
+
+		Id row = m_startRow;
+		for (size_t i = 0; i < text.size();)
+		{
+			row = rows[row + m_byteClasses[static_cast<unsigned char>(text[i++])]];
+			if (row < m_acceptingRowsEnd)
+			{
+				lastLength = i;
+				lastRow = row;
+			}
+			else if (row == m_deadRow)
+			{
+				break;
+			}
+		}
+
+		return { lastLength, lastRow == NO_ROW ? NO_TOKEN : rows[lastRow + m_classesCount] };
+	}
+
+	size_t GetStatesCount() const noexcept
+	{
+		return m_rows.size() / m_rowSize;
+	}
+
+	size_t GetClassesCount() const noexcept
+	{
+		return m_classesCount;
+	}
+
+private:
+	static constexpr Id NO_ROW = std::numeric_limits<Id>::max();
+
+	explicit LexerTable(const std::pair<MooreTable, ByteClasses>& compiled)
+		: LexerTable(compiled.first, compiled.second)
+	{
+	}
+
+	static std::pair<MooreTable, ByteClasses> CompileRules(const Rules& rules, size_t threadsCount)
+	{
+		if (rules.empty())
+		{
+			throw std::invalid_argument(lexer_excps::NO_RULES_MSG);
+		}
+
+		RegexCompiler compiler{};
+		for (auto& rule : rules)
+		{
+			compiler.Add(rule, static_cast<std::uint32_t>(compiler.GetPatternsCount() + 1));
+		}
+
+		auto table = Determinize(compiler.Build(), threadsCount);
+		table.Minimize(threadsCount);
+
+		return { std::move(table), compiler.GetByteClasses() };
+	}
+
+	static Id GetToken(const std::string& signalName)
+	{
+		unsigned char label{};
+		unsigned int index{};
+		if (TryParseSignalParts(signalName, label, index) != StateParseError::NONE
+			|| label != ACCEPT_SIGNALS_LABEL)
+		{
+			throw std::invalid_argument(lexer_excps::WRONG_OUTPUT_MSG + signalName);
+		}
+
+		return index == 0 ? NO_TOKEN : static_cast<Id>(index - 1);
+	}
+
+	// States from which some token is reachable, found by BFS over reversed transitions
+	static std::vector<bool> FindLiveStates(const MooreTable& table, const std::vector<Id>& tokens)
+	{
+		const auto& targets = table.GetTargets();
+		const auto statesCount = targets.GetStatesCount();
+
+		std::vector<Id> offsets(statesCount + 1);
+		for (auto target : targets.GetCells())
+		{
+			++offsets[target + 1];
+		}
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+		std::vector<Id> predecessors(targets.GetCells().size());
+		auto positions = offsets;
+		for (size_t input = 0; input < targets.GetInputsCount(); ++input)
+		{
+			auto row = targets.GetRow(input);
+			for (size_t state = 0; state < statesCount; ++state)
+			{
+				predecessors[positions[row[state]]++] = static_cast<Id>(state);
+			}
+		}
+
+		std::vector<bool> result(statesCount);
+		std::vector<Id> queue{};
+		for (size_t state = 0; state < statesCount; ++state)
+		{
+			if (tokens[state] != NO_TOKEN)
+			{
+				result[state] = true;
+				queue.push_back(static_cast<Id>(state));
+			}
+		}
+		for (size_t i = 0; i < queue.size(); ++i)
+		{
+			for (auto j = offsets[queue[i]]; j < offsets[queue[i] + 1]; ++j)
+			{
+				if (!result[predecessors[j]])
+				{
+					result[predecessors[j]] = true;
+					queue.push_back(predecessors[j]);
+				}
+			}
+		}
+
+		return result;
+	}
+
+	void BuildRows(const MooreTable& table)
+	{
+		const auto& targets = table.GetTargets();
+		const auto statesCount = targets.GetStatesCount();
+
+		std::vector<Id> tokens{};
+		tokens.reserve(statesCount);
+		for (auto signal : table.GetStateSignals())
+		{
+			tokens.push_back(GetToken(table.GetSignals().GetName(signal)));
+		}
+
+		// Accepting states go first, then other live states and the start state, then one row of dead states
+		auto isLive = FindLiveStates(table, tokens);
+		std::vector<Id> rowOf(statesCount, NO_ROW);
+		Id rowsCount = 0;
+		for (size_t state = 0; state < statesCount; ++state)
+		{
+			if (tokens[state] != NO_TOKEN)
+			{
+				rowOf[state] = static_cast<Id>(rowsCount++ * m_rowSize);
+			}
+		}
+		m_acceptingRowsEnd = static_cast<Id>(rowsCount * m_rowSize);
+		for (size_t state = 0; state < statesCount; ++state)
+		{
+			if (rowOf[state] == NO_ROW && (isLive[state] || state == 0))
+			{
+				rowOf[state] = static_cast<Id>(rowsCount++ * m_rowSize);
+			}
+		}
+		for (auto& row : rowOf)
+		{
+			if (row == NO_ROW)
+			{
+				if (m_deadRow == NO_ROW)
+				{
+					m_deadRow = static_cast<Id>(rowsCount++ * m_rowSize);
+				}
+				row = m_deadRow;
+			}
+		}
+		m_startRow = rowOf[0];
+
+		m_rows.assign(size_t{ rowsCount } * m_rowSize, NO_TOKEN);
+		for (size_t state = 0; state < statesCount; ++state)
+		{
+			auto row = m_rows.data() + rowOf[state];
+			for (size_t input = 0; input < m_classesCount; ++input)
+			{
+				row[input] = rowOf[targets.At(input, state)];
+			}
+			row[m_classesCount] = tokens[state];
+		}
+	}
+
+	ByteClasses m_byteClasses;
+	size_t m_classesCount;
+	size_t m_rowSize;
+	std::vector<Id> m_rows;
+	Id m_startRow;
+	Id m_acceptingRowsEnd;
+	Id m_deadRow;
+};
+
+// Splits input into tokens by maximal munch: for (Lexer lexer{ table, text }; lexer.Next(token);)
+class Lexer
+{
+public:
+	Lexer(const LexerTable& table, std::string_view input) noexcept
+		: m_table(table)
+		, m_input(input)
+	{
+	}
+
+	bool Next(Token& token) noexcept
+	{
+		if (m_input.empty())
+		{
+			return false;
+		}
+
+		auto [length, id] = m_table.Match(m_input);
+		if (length == 0)
+		{
+			length = 1;
+		}
+		token = Token{ id, m_input.substr(0, length) };
+		m_input.remove_prefix(length);
+
+		return true;
+	}
+
+private:
+	const LexerTable& m_table;
+	std::string_view m_input;
+};
+
+#endif // !AUTOMATA_LEXER_HPP_
@@ -1,85 +1,207 @@
 #ifndef AUTOMATA_MEALY_MOORE_TABLE_HPP_
 #define AUTOMATA_MEALY_MOORE_TABLE_HPP_
 
-#include <list>
-#include <map>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "ParallelRefinement.hpp"
+#include "PartitionRefinement.hpp"
+#include "Reachability.hpp"
 #include "State.hpp"
+#include "StatsCounters.hpp"
+#include "SymbolTable.hpp"
+#include "TransitionMatrix.hpp"
 
 class MooreTable;
 
-class MealyTable
+// Columns of states reachable from the first one, in their original order
+inline std::vector<size_t> GetReachableColumns(const TransitionMatrix& targets)
 {
-public:
-	using MealyStateRow = std::list<MealyState>;
-	using MealyStates = std::vector<MealyStateRow>;
+	std::vector<size_t> result{};
+	if (targets.GetStatesCount() == 0)
+	{
+		return result;
+	}
 
-	using States = std::list<State>;
-	using Transition = State;
-	using Transitions = std::list<Transition>;
+	auto reached = FindReachableStates(targets.GetStatesCount(), targets.GetInputsCount(), targets.GetCells(), 0);
+	result.reserve(reached.size());
+	for (size_t state = 0; state < reached.size(); ++state)
+	{
+		if (reached[state])
+		{
+			result.push_back(state);
+		}
+	}
 
-	using Signals = std::vector<Signal>;
-	using OutSignalColumns = std::list<Signals>;
+	return result;
+}
 
-	MealyTable(const MooreTable& mooreTable);
+// Maps every column to its new index after keeping only given columns
+inline std::vector<TransitionMatrix::Id> GetNewIndexes(const std::vector<size_t>& keptColumns, size_t columnsCount)
+{
+	std::vector<TransitionMatrix::Id> result(columnsCount);
+	for (size_t i = 0; i < keptColumns.size(); ++i)
+	{
+		result[keptColumns[i]] = static_cast<TransitionMatrix::Id>(i);
+	}
 
-	MealyTable(const States& states, const Transitions& transitions, const MealyStates& mealyStates)
-		: m_mealyStates(mealyStates)
-		, m_states(states)
-		, m_transitions(transitions)
+	return result;
+}
+
+// First state of every class, so that column of class i is taken from representatives[i]
+inline std::vector<size_t> GetRepresentatives(const HopcroftPartition::Classes& classes, size_t classesCount)
+{
+	const auto statesCount = classes.size();
+
+	std::vector<size_t> representatives(classesCount, statesCount);
+	for (size_t state = 0; state < statesCount; ++state)
 	{
+		if (representatives[classes[state]] == statesCount)
+		{
+			representatives[classes[state]] = state;
+		}
 	}
 
-	void Minimize()
+	return representatives;
+}
+
+// Classes of states with equal columns of the matrix. Columns are hashed in place row by row,
+// and columns with equal hashes are compared cell by cell, so no column is copied
+inline HopcroftPartition::Classes GetEqualColumnsClasses(const TransitionMatrix& matrix)
+{
+	const auto statesCount = matrix.GetStatesCount();
+	const auto inputsCount = matrix.GetInputsCount();
+
+	std::vector<std::pair<std::uint64_t, size_t>> order(statesCount);
+	for (size_t state = 0; state < statesCount; ++state)
 	{
-		RemoveUnreachableStates();
+		order[state] = { 0, state };
+	}
+	for (size_t input = 0; input < inputsCount; ++input)
+	{
+		auto row = matrix.GetRow(input);
+		for (size_t state = 0; state < statesCount; ++state)
+		{
+			order[state].first = MixHash(order[state].first ^ (row[state] + 0x9e3779b97f4a7c15ULL));
+		}
+	}
+	std::sort(order.begin(), order.end());
 
-		/*using Group = State;
-		std::map<State, Group> stateToGroup = 
-		auto signalColumns = CollectSignalColumns();
+	auto haveEqualColumns = [&](size_t lhs, size_t rhs) {
+		for (size_t input = 0; input < inputsCount; ++input)
+		{
+			if (matrix.At(input, lhs) != matrix.At(input, rhs))
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// Classes of the states with the current hash, more than one only if hashes of different columns collide
+	HopcroftPartition::Classes result(statesCount);
+	std::vector<std::pair<size_t, size_t>> hashClasses{};
+	size_t classesCount = 0;
+	for (size_t i = 0; i < statesCount; ++i)
+	{
+		auto state = order[i].second;
+		if (i == 0 || order[i].first != order[i - 1].first)
+		{
+			hashClasses.clear();
+		}
 
-		signalColumns.unique([columnIndex = 0](const auto& lhs, const auto& rhs) mutable {
+		auto hashClass = std::find_if(hashClasses.begin(), hashClasses.end(), [&](const auto& item) {
+			return haveEqualColumns(item.first, state);
+		});
+		if (hashClass == hashClasses.end())
+		{
+			hashClasses.emplace_back(state, classesCount++);
+			hashClass = hashClasses.end() - 1;
+		}
+		result[state] = hashClass->second;
+	}
 
-		});*/
+	return result;
+}
+
+// Classes of equivalent states and their count. Hopcroft's algorithm runs on one thread,
+// refinement by rounds of signatures is used when more threads are given
+inline std::pair<HopcroftPartition::Classes, size_t> FindEquivalenceClasses(const TransitionMatrix& targets,
+	const HopcroftPartition::Classes& initialClasses,
+	size_t threadsCount)
+{
+	if (threadsCount > 1)
+	{
+		auto partition = ParallelPartition{ targets.GetStatesCount(), targets.GetInputsCount(), targets.GetCells(), initialClasses, threadsCount };
+		StatsCounters::Add(StatsCounter::PARALLEL_REFINEMENT_ROUNDS, partition.GetRoundsCount());
+		return { partition.GetClasses(), partition.GetClassesCount() };
 	}
 
-	const MealyStates& GetMealyStates() const noexcept
+	auto partition = HopcroftPartition{ targets.GetStatesCount(), targets.GetInputsCount(), targets.GetCells(), initialClasses };
+	StatsCounters::Add(StatsCounter::HOPCROFT_SPLITTERS, partition.GetSplittersCount());
+	return { partition.GetClasses(), partition.GetClassesCount() };
+}
+
+// Label of generated state names, taken from the first state
+inline char GetStatesLabel(const SymbolTable& states)
+{
+	return (states.IsEmpty() || states.GetName(0).empty()) ? 'q' : states.GetName(0).front();
+}
+
+class MealyTable
+{
+public:
+	MealyTable(const MooreTable& mooreTable);
+
+	MealyTable(const SymbolTable& states,
+		const SymbolTable& transitions,
+		const SymbolTable& signals,
+		const TransitionMatrix& targets,
+		const TransitionMatrix& outputs)
+		: m_states(states)
+		, m_transitions(transitions)
+		, m_signals(signals)
+		, m_targets(targets)
+		, m_outputs(outputs)
 	{
-		return m_mealyStates;
+		CheckMatrix(m_targets);
+		CheckMatrix(m_outputs);
 	}
 
-	const States& GetStates() const noexcept
+	void Minimize(size_t threadsCount = 1)
+	{
+		RemoveUnreachableStates();
+		MergeEquivalentStates(threadsCount);
+	}
+
+	const SymbolTable& GetStates() const noexcept
 	{
 		return m_states;
 	}
 
-	const Transitions& GetTransitions() const noexcept
+	const SymbolTable& GetTransitions() const noexcept
 	{
 		return m_transitions;
 	}
 
-	const MealyState& GetCertainMealyState(const Transition& transition, const State& state) const
+	// Output signals, indexed by ids stored in GetOutputs()
+	const SymbolTable& GetSignals() const noexcept
 	{
-		auto it = std::find(m_transitions.begin(), m_transitions.end(), transition);
-		if (it == m_transitions.end())
-		{
-			throw std::out_of_range("MealyTable doesn't contain given transition");
-		}
-
-		auto columnIt = std::find(m_states.begin(), m_states.end(), state);
-		if (columnIt == m_states.end())
-		{
-			throw std::out_of_range("MealyTable doesn't contain given state");
-		}
-
-		auto rowIndex = std::distance(m_transitions.begin(), it);
-		auto columnIndex = std::distance(m_states.begin(), columnIt);
+		return m_signals;
+	}
 
-		auto begIt = m_mealyStates[rowIndex].begin();
-		std::advance(begIt, columnIndex);
+	const TransitionMatrix& GetTargets() const noexcept
+	{
+		return m_targets;
+	}
 
-		return *begIt;
+	const TransitionMatrix& GetOutputs() const noexcept
+	{
+		return m_outputs;
 	}
 
 	friend std::ostream& operator<<(std::ostream& lhs, const MealyTable& rhs)
@@ -91,20 +213,22 @@ public:
 		}
 
 		const auto delimeter = ';';
-		for (auto& columnName : rhs.m_states)
+		for (auto& columnName : rhs.m_states.GetNames())
 		{
 			lhs << delimeter << columnName;
 		}
 
 		size_t rowIndex = 0;
-		for (auto& transition : rhs.m_transitions)
+		for (auto& transition : rhs.m_transitions.GetNames())
 		{
 			lhs << '\n';
 			lhs << transition;
-			for (auto& field : rhs.m_mealyStates[rowIndex++])
+			for (size_t stateIndex = 0; stateIndex < rhs.m_states.GetSize(); ++stateIndex)
 			{
-				lhs << delimeter << field;
+				lhs << delimeter << rhs.m_states.GetName(rhs.m_targets.At(rowIndex, stateIndex))
+					<< '/' << rhs.m_signals.GetName(rhs.m_outputs.At(rowIndex, stateIndex));
 			}
+			++rowIndex;
 		}
 
 		return (lhs << std::endl);
@@ -113,136 +237,98 @@ public:
 private:
 	void ComputeMealyStatesFromMoore(const MooreTable& mooreTable);
 
-	std::vector<size_t> GetUnreachableStatesIndexes() const
+	void CheckMatrix(const TransitionMatrix& matrix) const
 	{
-		std::vector<size_t> result{};
-		result.reserve(m_states.size());
-
-		size_t stateIndex{};
-		for (const auto& state : m_states)
+		if (matrix.GetInputsCount() != m_transitions.GetSize() || matrix.GetStatesCount() != m_states.GetSize())
 		{
-			bool hasTransitionFromOtherStates = true;
-			for (const auto& row : m_mealyStates)
-			{
-				hasTransitionFromOtherStates = std::any_of(row.begin(), row.end(),
-					[&state, mealyStateIndex = 0, stateIndex](const auto& mealyState) mutable noexcept {
-						bool areStatesEqual = mealyState.m_state == state;
-						bool isTransitionFromOtherState = mealyStateIndex++ != stateIndex;
-
-						return areStatesEqual && isTransitionFromOtherState;
-					});
-				if (hasTransitionFromOtherStates)
-				{
-					break;
-				}
-			}
-			if (!hasTransitionFromOtherStates)
-			{
-				result.push_back(stateIndex);
-			}
-			++stateIndex;
+			throw std::invalid_argument("Failed to fill Mealy table. Matrix size doesn't match transitions and states count");
 		}
-
-		result.shrink_to_fit();
-		return result;
 	}
 
-	void EraseCertainColumns(const std::vector<size_t>& indexes)
+	void MergeEquivalentStates(size_t threadsCount)
 	{
-		if (indexes.empty())
+		if (m_states.IsEmpty())
 		{
 			return;
 		}
 
-		for (auto& row : m_mealyStates)
-		{
-			size_t erasedCounter{};
-			for (const auto& index : indexes)
-			{
-				auto itToErase = row.begin();
-				std::advance(itToErase, index - erasedCounter++);
-				row.erase(itToErase);
-			}
-		}
-	}
-
-	void EraseCertainStates(const std::vector<size_t>& indexes)
-	{
-		size_t erasedCounter{};
-		for (const auto& index : indexes)
-		{
-			auto itToErase = m_states.begin();
-			std::advance(itToErase, index - erasedCounter++);
-			m_states.erase(itToErase);
-		}
-	}
-
-	OutSignalColumns CollectSignalColumns() const
-	{
-		OutSignalColumns res{};
+		const auto statesCount = m_states.GetSize();
 
-		for (size_t i = 0; i < m_mealyStates.front().size(); ++i)
+		// States are 0-equivalent when they give the same output signal for every input
+		auto initialClasses = GetEqualColumnsClasses(m_outputs);
+		auto [classes, classesCount] = FindEquivalenceClasses(m_targets, initialClasses, threadsCount);
+		if (classesCount == statesCount)
 		{
-			res.emplace_back(Signals{});
+			return;
 		}
 
-		for (const auto& row : m_mealyStates)
-		{
-			auto resIt = res.begin();
-			for (const auto& mealyState : row)
-			{
-				(*resIt++).emplace_back(mealyState.m_signal);
-			}
-		}
+		auto representatives = GetRepresentatives(classes, classesCount);
 
-		return res;
+		m_states = SymbolTable::MakeIndexed(GetStatesLabel(m_states), classesCount);
+		m_targets = m_targets.SelectColumns(representatives);
+		m_targets.RemapIds(std::vector<TransitionMatrix::Id>(classes.begin(), classes.end()));
+		m_outputs = m_outputs.SelectColumns(representatives);
 	}
 
 	void RemoveUnreachableStates()
 	{
-		auto columnIndexesToIgnore{ std::move(GetUnreachableStatesIndexes()) };
-
-		if (!columnIndexesToIgnore.empty())
+		auto reachableColumns = GetReachableColumns(m_targets);
+		if (reachableColumns.size() == m_states.GetSize())
 		{
-			EraseCertainStates(columnIndexesToIgnore);
-			EraseCertainColumns(columnIndexesToIgnore);
+			return;
 		}
+
+		m_targets = m_targets.SelectColumns(reachableColumns);
+		m_targets.RemapIds(GetNewIndexes(reachableColumns, m_states.GetSize()));
+		m_outputs = m_outputs.SelectColumns(reachableColumns);
+		m_states = m_states.Select(reachableColumns);
 	}
 
-	MealyStates m_mealyStates;
-	States m_states;
-	Transitions m_transitions;
+	SymbolTable m_states;
+	SymbolTable m_transitions;
+	SymbolTable m_signals;
+
+	TransitionMatrix m_targets;
+	TransitionMatrix m_outputs;
 };
 
 class MooreTable
 {
 public:
-	using Signals = std::vector<Signal>;
-	using States = std::list<State>;
+	using StateSignals = std::vector<SymbolTable::Id>;
 
-	using Transition = State;
-	using Transitions = std::list<Transition>;
+	// Target state's id and output signal's id of a Mealy table's cell
+	using MealyCell = std::pair<TransitionMatrix::Id, TransitionMatrix::Id>;
 
-	using MooreStatesRow = std::list<MooreState>;
-	using MooreStatesTable = std::vector<MooreStatesRow>;
-
-	MooreTable(const Signals& signals,
-		const States& states,
-		const Transitions& transitions,
-		const MooreStatesTable& mooreTable)
+	MooreTable(const SymbolTable& signals,
+		const StateSignals& stateSignals,
+		const SymbolTable& states,
+		const SymbolTable& transitions,
+		const TransitionMatrix& targets)
 		: m_signals(signals)
+		, m_stateSignals(stateSignals)
 		, m_states(states)
 		, m_transitions(transitions)
-		, m_mooreTable(mooreTable)
+		, m_targets(targets)
 	{
+		if (m_stateSignals.size() != m_states.GetSize())
+		{
+			throw std::invalid_argument("Failed to fill Moore table. Signals count doesn't match states count");
+		}
+		if (m_targets.GetInputsCount() != m_transitions.GetSize() || m_targets.GetStatesCount() != m_states.GetSize())
+		{
+			throw std::invalid_argument("Failed to fill Moore table. Matrix size doesn't match transitions and states count");
+		}
 	}
 
 	MooreTable(const MealyTable& mealyTable)
-		: m_signals()
+		: m_stateToMealyCell()
+		, m_mealyCellToState()
+		, m_signals()
+		, m_stateSignals()
 		, m_states()
 		, m_transitions()
-		, m_mooreTable()
-		, m_stateToMealyState()
+		, m_targets()
 	{
 		CollectStatesFromMealy(mealyTable);
 		CollectSignalsFromMealy(mealyTable);
@@ -250,29 +336,50 @@ public:
 		ComputeMooreTableWithMealy(mealyTable);
 	}
 
-	void Minimize()
+	void Minimize(size_t threadsCount = 1)
 	{
 		RemoveUnreachableStates();
+		MergeEquivalentStates(threadsCount);
 	}
 
-	const Signals& GetSignals() const
+	void RemoveUnreachableStates()
+	{
+		auto reachableColumns = GetReachableColumns(m_targets);
+		if (reachableColumns.size() == m_states.GetSize())
+		{
+			return;
+		}
+
+		m_stateSignals = SelectStateSignals(reachableColumns);
+		m_targets = m_targets.SelectColumns(reachableColumns);
+		m_targets.RemapIds(GetNewIndexes(reachableColumns, m_states.GetSize()));
+		m_states = m_states.Select(reachableColumns);
+	}
+
+	// Distinct output signals, indexed by ids stored in GetStateSignals()
+	const SymbolTable& GetSignals() const
 	{
 		return m_signals;
 	}
 
-	const States& GetStates() const
+	const StateSignals& GetStateSignals() const
+	{
+		return m_stateSignals;
+	}
+
+	const SymbolTable& GetStates() const
 	{
 		return m_states;
 	}
 
-	const Transitions& GetTransitions() const
+	const SymbolTable& GetTransitions() const
 	{
 		return m_transitions;
 	}
 
-	const MooreStatesTable& GetMooreStates() const
+	const TransitionMatrix& GetTargets() const noexcept
 	{
-		return m_mooreTable;
+		return m_targets;
 	}
 
 	friend std::ostream& operator<<(std::ostream& lhs, const MooreTable& rhs)
@@ -284,240 +391,232 @@ public:
 		}
 
 		const auto delimeter = ';';
-		for (auto& signal : rhs.m_signals)
+		for (auto& signal : rhs.m_stateSignals)
 		{
-			lhs << delimeter << signal;
+			lhs << delimeter << rhs.m_signals.GetName(signal);
 		}
 		lhs << '\n';
 
-		for (auto& state : rhs.m_states)
+		for (auto& state : rhs.m_states.GetNames())
 		{
 			lhs << delimeter << state;
 		}
 
 		size_t rowIndex = 0;
-		for (auto& transition : rhs.m_transitions)
+		for (auto& transition : rhs.m_transitions.GetNames())
 		{
 			lhs << '\n';
 			lhs << transition;
-			if (rhs.m_mooreTable.size() != 0)
+			for (size_t stateIndex = 0; stateIndex < rhs.m_states.GetSize(); ++stateIndex)
 			{
-				for (auto& field : rhs.m_mooreTable[rowIndex++])
-				{
-					lhs << delimeter << field;
-				}
+				lhs << delimeter << rhs.m_states.GetName(rhs.m_targets.At(rowIndex, stateIndex));
 			}
+			++rowIndex;
 		}
 
 		return (lhs << std::endl);
 	}
 
 private:
-	void CollectSignalsFromMealy(const MealyTable& mealyTable)
+	StateSignals SelectStateSignals(const std::vector<size_t>& columns) const
 	{
-		m_signals.reserve(m_stateToMealyState.size());
-		for (auto& [_state, _mealyState] : m_stateToMealyState)
+		StateSignals result{};
+		result.reserve(columns.size());
+		for (auto column : columns)
 		{
-			m_signals.emplace_back(_mealyState.m_signal);
+			result.push_back(m_stateSignals[column]);
 		}
+
+		return result;
 	}
 
-	void CollectStatesFromMealy(const MealyTable& mealyTable)
+	void CollectSignalsFromMealy(const MealyTable& mealyTable)
 	{
-		std::list<MealyState> uniqueMealyStates{};
-		for (auto& stateList : mealyTable.GetMealyStates())
+		m_signals = mealyTable.GetSignals();
+		m_stateSignals.reserve(m_stateToMealyCell.size());
+		for (auto& [_state, _signal] : m_stateToMealyCell)
 		{
-			for (auto& state : stateList)
-			{
-				uniqueMealyStates.emplace_back(state);
-			}
-		}
-		uniqueMealyStates.sort();
-		uniqueMealyStates.unique();
-
-		unsigned int index = 0;
-		for (auto& uMState : uniqueMealyStates)
-		{
-			auto state = State{ 'q', index++ };
-			m_stateToMealyState.emplace(std::make_pair(state, uMState));
-			m_states.emplace_back(std::move(state));
+			m_stateSignals.emplace_back(_signal);
 		}
 	}
 
-	void CollectTransitionsFromMealy(const MealyTable& mealyTable)
+	static std::uint64_t GetMealyCellKey(const MealyCell& cell) noexcept
 	{
-		for (auto& transition : mealyTable.GetTransitions())
-		{
-			m_transitions.emplace_back(transition);
-		}
+		return (static_cast<std::uint64_t>(cell.first) << 32) | cell.second;
 	}
 
-	void ComputeMooreTableWithMealy(const MealyTable& mealyTable)
+	// Moore states are created only for (state, signal) cells met on the way from the first Mealy state.
+	// If the first Mealy state is never entered again, it gets its own Moore state with the signal of its
+	// first transition: initial output of Moore's automaton isn't observed by the equivalent Mealy's one
+	void CollectStatesFromMealy(const MealyTable& mealyTable)
 	{
-		if (m_states.empty())
+		const auto& targets = mealyTable.GetTargets();
+		const auto& outputs = mealyTable.GetOutputs();
+		if (targets.GetStatesCount() == 0 || targets.GetInputsCount() == 0)
 		{
 			throw std::logic_error("Failed to fill Moore table from Mealy.");
 		}
 
-		{
-			m_mooreTable.reserve(m_transitions.size());
-			for (auto& transition : m_transitions)
+		ReachedStates expanded(targets.GetStatesCount(), false);
+		bool isStartEntered = false;
+		auto expand = [&](TransitionMatrix::Id mealyState) {
+			if (expanded[mealyState])
 			{
-				m_mooreTable.emplace_back(MooreStatesRow());
+				return;
 			}
-		}
-
-		for (auto& state : m_states)
-		{
-			auto& mealyState = m_stateToMealyState[state];
-			auto& mealyInnerState = mealyState.m_state;
+			expanded[mealyState] = true;
 
-			size_t rowIndex = 0;
-			for (auto& transition : m_transitions)
+			for (size_t input = 0; input < targets.GetInputsCount(); ++input)
 			{
-				auto& certainMealyState = mealyTable.GetCertainMealyState(transition, mealyInnerState);
-				auto _state = std::invoke([&] {
-					for (auto& [_state, mealyState] : m_stateToMealyState)
-					{
-						if (mealyState == certainMealyState)
-						{
-							return _state;
-						}
-					}
-
-					throw std::logic_error("Failed to fill Moore table from Mealy. Not enough states");
-				});
-
-				m_mooreTable[rowIndex++].emplace_back(_state);
+				auto cell = MealyCell{ targets.At(input, mealyState), outputs.At(input, mealyState) };
+				if (m_mealyCellToState.emplace(GetMealyCellKey(cell), TransitionMatrix::Id{}).second)
+				{
+					isStartEntered = isStartEntered || cell.first == 0;
+					m_stateToMealyCell.push_back(cell);
+				}
 			}
+		};
+
+		expand(0);
+		for (size_t head = 0; head < m_stateToMealyCell.size(); ++head)
+		{
+			expand(m_stateToMealyCell[head].first);
 		}
-	}
 
-	void EraseCertainColumns(const std::vector<size_t>& columnIndexes)
-	{
-		if (columnIndexes.empty())
+		if (!isStartEntered)
 		{
-			return;
+			auto startCell = MealyCell{ 0, outputs.At(0, 0) };
+			m_mealyCellToState.emplace(GetMealyCellKey(startCell), TransitionMatrix::Id{});
+			m_stateToMealyCell.push_back(startCell);
 		}
 
-		for (auto& row : m_mooreTable)
+		// Moore states are numbered in order of Mealy states' columns and then of output signals' names
+		const auto& signalNames = mealyTable.GetSignals().GetNames();
+		std::vector<Signal> signalKeys{};
+		signalKeys.reserve(signalNames.size());
+		for (auto& name : signalNames)
+		{
+			signalKeys.emplace_back(Signal{ name });
+		}
+		std::vector<TransitionMatrix::Id> signalsOrder(signalNames.size());
+		std::iota(signalsOrder.begin(), signalsOrder.end(), TransitionMatrix::Id{});
+		std::sort(signalsOrder.begin(), signalsOrder.end(), [&signalKeys](auto lhs, auto rhs) {
+			return signalKeys[lhs] < signalKeys[rhs];
+		});
+		std::vector<TransitionMatrix::Id> signalRanks(signalNames.size());
+		for (size_t rank = 0; rank < signalsOrder.size(); ++rank)
 		{
-			size_t erasedCounter{};
-			for (const auto& index : columnIndexes)
+			signalRanks[signalsOrder[rank]] = static_cast<TransitionMatrix::Id>(rank);
+		}
+
+		std::sort(m_stateToMealyCell.begin(), m_stateToMealyCell.end(), [&signalRanks](const auto& lhs, const auto& rhs) {
+			if (lhs.first != rhs.first)
 			{
-				auto itToErase = row.begin();
-				std::advance(itToErase, index - erasedCounter++);
-				row.erase(itToErase);
+				return lhs.first < rhs.first;
 			}
+			return signalRanks[lhs.second] < signalRanks[rhs.second];
+		});
+
+		TransitionMatrix::Id stateIndex = 0;
+		for (auto& cell : m_stateToMealyCell)
+		{
+			m_mealyCellToState[GetMealyCellKey(cell)] = stateIndex++;
 		}
+
+		m_states = SymbolTable::MakeIndexed('q', m_stateToMealyCell.size());
 	}
 
-	void EraseCertainSignals(const std::vector<size_t>& statesIndexes)
+	void CollectTransitionsFromMealy(const MealyTable& mealyTable)
 	{
-		size_t erasedCounter{};
-		for (const auto& index : statesIndexes)
-		{
-			auto itToErase = m_signals.begin();
-			std::advance(itToErase, index - erasedCounter++);
-			m_signals.erase(itToErase);
-		}
+		m_transitions = mealyTable.GetTransitions();
 	}
 
-	void EraseCertainStates(const std::vector<size_t>& statesIndexes)
+	void ComputeMooreTableWithMealy(const MealyTable& mealyTable)
 	{
-		size_t erasedCounter{};
-		for (const auto& index : statesIndexes)
+		if (m_states.IsEmpty())
 		{
-			auto itToErase = m_states.begin();
-			std::advance(itToErase, index - erasedCounter++);
-			m_states.erase(itToErase);
+			throw std::logic_error("Failed to fill Moore table from Mealy.");
 		}
-	}
 
-	std::vector<size_t> GetUnreachableStatesIndexes() const
-	{
-		std::vector<size_t> result{};
+		const auto& mealyTargets = mealyTable.GetTargets();
+		const auto& mealyOutputs = mealyTable.GetOutputs();
+
+		m_targets = TransitionMatrix{ m_transitions.GetSize(), m_states.GetSize() };
 
-		size_t stateIndex{};
-		for (const auto& state : m_states)
+		for (size_t rowIndex = 0; rowIndex < m_transitions.GetSize(); ++rowIndex)
 		{
-			bool hasTransitionFromOtherStates = true;
-			for (const auto& row : m_mooreTable)
+			auto mealyTargetsRow = mealyTargets.GetRow(rowIndex);
+			auto mealyOutputsRow = mealyOutputs.GetRow(rowIndex);
+
+			for (size_t stateIndex = 0; stateIndex < m_states.GetSize(); ++stateIndex)
 			{
-				hasTransitionFromOtherStates = std::any_of(row.begin(), row.end(),
-					[&state, mealyStateIndex = 0, stateIndex](const auto& mooreState) mutable noexcept {
-						bool areStatesEqual = mooreState.m_state == state;
-						bool isTransitionFromOtherState = mealyStateIndex++ != stateIndex;
-
-						return areStatesEqual && isTransitionFromOtherState;
-					});
-				if (hasTransitionFromOtherStates)
+				auto mealyInnerState = m_stateToMealyCell[stateIndex].first;
+				auto certainMealyCell = MealyCell{ mealyTargetsRow[mealyInnerState], mealyOutputsRow[mealyInnerState] };
+
+				auto it = m_mealyCellToState.find(GetMealyCellKey(certainMealyCell));
+				if (it == m_mealyCellToState.end())
 				{
-					break;
+					throw std::logic_error("Failed to fill Moore table from Mealy. Not enough states");
 				}
+				m_targets.At(rowIndex, stateIndex) = it->second;
 			}
-			if (!hasTransitionFromOtherStates)
-			{
-				result.push_back(stateIndex);
-			}
-			++stateIndex;
 		}
-
-		return result;
 	}
 
-	void RemoveUnreachableStates()
+	void MergeEquivalentStates(size_t threadsCount)
 	{
-		auto columnIndexesToIgnore{ std::move(GetUnreachableStatesIndexes()) };
+		if (m_states.IsEmpty())
+		{
+			return;
+		}
+
+		const auto statesCount = m_states.GetSize();
 
-		if (!columnIndexesToIgnore.empty())
+		HopcroftPartition::Classes initialClasses(m_stateSignals.begin(), m_stateSignals.end());
+		auto [classes, classesCount] = FindEquivalenceClasses(m_targets, initialClasses, threadsCount);
+		if (classesCount == statesCount)
 		{
-			EraseCertainSignals(columnIndexesToIgnore);
-			EraseCertainStates(columnIndexesToIgnore);
-			EraseCertainColumns(columnIndexesToIgnore);
+			return;
 		}
+
+		auto representatives = GetRepresentatives(classes, classesCount);
+
+		m_stateSignals = SelectStateSignals(representatives);
+		m_states = SymbolTable::MakeIndexed(GetStatesLabel(m_states), classesCount);
+		m_targets = m_targets.SelectColumns(representatives);
+		m_targets.RemapIds(std::vector<TransitionMatrix::Id>(classes.begin(), classes.end()));
 	}
 
-	std::map<State, MealyState> m_stateToMealyState;
+	std::vector<MealyCell> m_stateToMealyCell;
+	std::unordered_map<std::uint64_t, TransitionMatrix::Id> m_mealyCellToState;
 
-	Signals m_signals;
-	States m_states;
-	Transitions m_transitions;
-	MooreStatesTable m_mooreTable;
+	SymbolTable m_signals;
+	StateSignals m_stateSignals;
+	SymbolTable m_states;
+	SymbolTable m_transitions;
+	TransitionMatrix m_targets;
 };
 
-MealyTable::MealyTable(const MooreTable& mooreTable)
-	: m_mealyStates()
-	, m_states(mooreTable.GetStates())
+inline MealyTable::MealyTable(const MooreTable& mooreTable)
+	: m_states(mooreTable.GetStates())
 	, m_transitions(mooreTable.GetTransitions())
+	, m_signals(mooreTable.GetSignals())
+	, m_targets(mooreTable.GetTargets())
+	, m_outputs(m_transitions.GetSize(), m_states.GetSize())
 {
 	ComputeMealyStatesFromMoore(mooreTable);
 }
 
-void MealyTable::ComputeMealyStatesFromMoore(const MooreTable& mooreTable)
+inline void MealyTable::ComputeMealyStatesFromMoore(const MooreTable& mooreTable)
 {
-	m_mealyStates.reserve(m_transitions.size());
-	for (auto& transition : m_transitions)
+	// Output of a transition is the signal of the Moore state it leads to
+	const auto& stateSignals = mooreTable.GetStateSignals();
+	for (size_t transitionIndex = 0; transitionIndex < m_transitions.GetSize(); ++transitionIndex)
 	{
-		m_mealyStates.emplace_back(MealyStateRow());
-	}
-
-	auto& mooreTableContent = mooreTable.GetMooreStates();
-	const auto& mooreSignals = mooreTable.GetSignals();
-
-	auto itStates = m_mealyStates.begin();
-	for (auto& row : mooreTableContent)
-	{
-		for (auto& field : row)
+		for (size_t stateIndex = 0; stateIndex < m_states.GetSize(); ++stateIndex)
 		{
-			if (field.m_state.m_index >= mooreSignals.size())
-			{
-				throw std::out_of_range("Failed to fill Mealy Table from Moore. Not enough signals");
-			}
-			(*itStates).emplace_back(MealyState{
-				field.m_state, mooreSignals[field.m_state.m_index] });
+			m_outputs.At(transitionIndex, stateIndex) = stateSignals[m_targets.At(transitionIndex, stateIndex)];
 		}
-		++itStates;
 	}
 }
 
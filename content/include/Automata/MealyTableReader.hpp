@@ -1,86 +1,121 @@
 #ifndef AUTOMATA_MEALY_TABLE_READER_HPP_
 #define AUTOMATA_MEALY_TABLE_READER_HPP_
 
-#include <list>
 #include <vector>
 
-#include "../CSV/csv.hpp"
 #include "State.hpp"
+#include "SymbolTable.hpp"
+#include "TableScanner.hpp"
+#include "TransitionMatrix.hpp"
 
 class MealyTableReader
 {
 public:
-	using MealyStatesRow = std::list<MealyState>;
-	using MealyStates = std::vector<MealyStatesRow>;
-
-	using States = std::list<State>;
-	using Transition = State;
-	using Transitions = std::list<Transition>;
-
-	MealyTableReader(csv::CSVReader& reader)
-		: m_reader(reader)
-		, m_mealyStates()
-		, m_transitions()
+	MealyTableReader(std::string_view content)
+		: m_scanner(content)
 		, m_states()
+		, m_transitions()
+		, m_signals()
+		, m_targets()
+		, m_outputs()
 	{
 		ReadColumnNames();
 		ReadRows();
 	}
 
-	const MealyStates& GetMealyStates() const noexcept
+	const SymbolTable& GetStates() const noexcept
 	{
-		return m_mealyStates;
+		return m_states;
 	}
 
-	const States& GetStates() const noexcept
+	const SymbolTable& GetTransitions() const noexcept
 	{
-		return m_states;
+		return m_transitions;
 	}
 
-	const Transitions& GetTransitions() const noexcept
+	const SymbolTable& GetSignals() const noexcept
 	{
-		return m_transitions;
+		return m_signals;
+	}
+
+	const TransitionMatrix& GetTargets() const noexcept
+	{
+		return m_targets;
+	}
+
+	const TransitionMatrix& GetOutputs() const noexcept
+	{
+		return m_outputs;
 	}
 
 private:
 	void ReadColumnNames()
 	{
-		for (auto& cName : m_reader.get_col_names())
+		std::string_view line{};
+		if (!m_scanner.ReadLine(line))
+		{
+			throw std::invalid_argument("Failed to read Mealy table. Table is empty");
+		}
+
+		std::string_view cName{};
+		for (FieldsRange fields{ line }; fields.Next(cName);)
 		{
 			if (cName.empty())
 			{
 				continue;
 			}
-			m_states.emplace_back(State{ cName });
+			ThrowIfFailed(CheckSignalName(cName));
+			m_states.InternUnique(cName);
 		}
 	}
 
 	void ReadRows()
 	{
-		for (auto& row : m_reader)
+		TransitionMatrix::Cells targets{};
+		TransitionMatrix::Cells outputs{};
+
+		for (std::string_view line{}; m_scanner.ReadLine(line);)
 		{
-			m_transitions.emplace_back(State{ row[0].get_sv() });
+			FieldsRange fields{ line };
 
-			auto stateRow = MealyStatesRow();
-			auto i = 0;
-			for (auto& field : row)
+			std::string_view transition{};
+			fields.Next(transition);
+			ThrowIfFailed(CheckSignalName(transition));
+			m_transitions.InternUnique(transition);
+
+			size_t fieldsCount = 0;
+			for (std::string_view content{}; fields.Next(content); ++fieldsCount)
 			{
-				if (i == 0)
+				std::string_view stateName{};
+				std::string_view signalName{};
+				ThrowIfFailed(TrySplitMealyState(content, stateName, signalName));
+
+				auto target = m_states.FindId(stateName);
+				if (!target)
 				{
-					++i;
-					continue;
+					throw std::out_of_range("Mealy table doesn't contain transition's target state " + std::string(stateName));
 				}
-				stateRow.emplace_back(MealyState{ field.get_sv() });
+				targets.push_back(*target);
+				outputs.push_back(m_signals.Intern(signalName));
+			}
+
+			if (fieldsCount != m_states.GetSize())
+			{
+				throw std::invalid_argument("Failed to read Mealy table. Row size doesn't match states count");
 			}
-			m_mealyStates.emplace_back(std::move(stateRow));
 		}
+
+		m_targets = TransitionMatrix{ m_transitions.GetSize(), m_states.GetSize(), std::move(targets) };
+		m_outputs = TransitionMatrix{ m_transitions.GetSize(), m_states.GetSize(), std::move(outputs) };
 	}
 
-	csv::CSVReader& m_reader;
+	TableScanner m_scanner;
 
-	MealyStates m_mealyStates;
-	States m_states;
-	Transitions m_transitions;
+	SymbolTable m_states;
+	SymbolTable m_transitions;
+	SymbolTable m_signals;
+	TransitionMatrix m_targets;
+	TransitionMatrix m_outputs;
 };
 
 #endif // !AUTOMATA_MEALY_TABLE_READER_HPP_
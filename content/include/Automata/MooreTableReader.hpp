@@ -1,111 +1,141 @@
 #ifndef AUTOMATA_MOORE_TABLE_READER_HPP_
 #define AUTOMATA_MOORE_TABLE_READER_HPP_
 
-#include <list>
 #include <vector>
 
-#include "../CSV/csv.hpp"
 #include "State.hpp"
+#include "SymbolTable.hpp"
+#include "TableScanner.hpp"
+#include "TransitionMatrix.hpp"
 
 class MooreTableReader
 {
 public:
-	using Signals = std::vector<Signal>;
-	using States = std::list<State>;
-	using Transitions = std::list<State>;
+	using StateSignals = std::vector<SymbolTable::Id>;
 
-	using MooreStatesRow = std::list<MooreState>;
-	using MooreStatesTable = std::vector<MooreStatesRow>;
-
-	MooreTableReader(csv::CSVReader& reader)
-		: m_reader(reader)
+	MooreTableReader(std::string_view content)
+		: m_scanner(content)
 		, m_signals()
+		, m_stateSignals()
 		, m_states()
 		, m_transitions()
-		, m_mooreTable()
+		, m_targets()
 	{
 		ReadSignals();
 		ReadStates();
 		ReadRows();
 	}
 
-	const Signals& GetSignals() const
+	const SymbolTable& GetSignals() const
 	{
 		return m_signals;
 	}
 
-	const States& GetStates() const
+	// Id of output signal in GetSignals() for every state
+	const StateSignals& GetStateSignals() const
+	{
+		return m_stateSignals;
+	}
+
+	const SymbolTable& GetStates() const
 	{
 		return m_states;
 	}
 
-	const Transitions& GetTransitions() const
+	const SymbolTable& GetTransitions() const
 	{
 		return m_transitions;
 	}
 
-	const MooreStatesTable& GetMooreStates() const
+	const TransitionMatrix& GetTargets() const
 	{
-		return m_mooreTable;
+		return m_targets;
 	}
 
 private:
+	std::string_view ReadHeaderLine()
+	{
+		std::string_view line{};
+		if (!m_scanner.ReadLine(line))
+		{
+			throw std::invalid_argument("Failed to read Moore table. Table must start with signals and states lines");
+		}
+
+		return line;
+	}
+
 	void ReadSignals()
 	{
-		for (auto& cName : m_reader.get_col_names())
+		std::string_view cName{};
+		for (FieldsRange fields{ ReadHeaderLine() }; fields.Next(cName);)
 		{
 			if (cName.empty())
 			{
 				continue;
 			}
-			m_signals.emplace_back(Signal{ cName });
+			ThrowIfFailed(CheckSignalName(cName));
+			m_stateSignals.push_back(m_signals.Intern(cName));
 		}
 	}
 
 	void ReadStates()
 	{
-		csv::CSVRow row;
-		m_reader.read_row(row);
-
-		for (auto& field : row)
+		std::string_view fieldContent{};
+		for (FieldsRange fields{ ReadHeaderLine() }; fields.Next(fieldContent);)
 		{
-			if (auto fieldContent = field.get_sv(); !fieldContent.empty())
+			if (!fieldContent.empty())
 			{
-				m_states.emplace_back(State{ fieldContent });
+				ThrowIfFailed(CheckSignalName(fieldContent));
+				m_states.InternUnique(fieldContent);
 			}
 		}
+
+		if (m_states.GetSize() != m_stateSignals.size())
+		{
+			throw std::invalid_argument("Failed to read Moore table. Signals count doesn't match states count");
+		}
 	}
 
 	void ReadRows()
 	{
-		for (auto& row : m_reader)
+		TransitionMatrix::Cells targets{};
+
+		for (std::string_view line{}; m_scanner.ReadLine(line);)
 		{
-			if (auto transitionContent = row[0].get_sv(); !transitionContent.empty())
-			{
-				m_transitions.emplace_back(State{ transitionContent });
-			}
+			FieldsRange fields{ line };
 
-			auto stateRow = MooreStatesRow();
-			auto i = 0;
-			for (auto& field : row)
+			std::string_view transition{};
+			fields.Next(transition);
+			ThrowIfFailed(CheckSignalName(transition));
+			m_transitions.InternUnique(transition);
+
+			size_t fieldsCount = 0;
+			for (std::string_view stateName{}; fields.Next(stateName); ++fieldsCount)
 			{
-				if (i == 0)
+				auto target = m_states.FindId(stateName);
+				if (!target)
 				{
-					++i;
-					continue;
+					throw std::out_of_range("Moore table doesn't contain transition's target state " + std::string(stateName));
 				}
-				stateRow.emplace_back(MooreState{ field.get_sv() });
+				targets.push_back(*target);
+			}
+
+			if (fieldsCount != m_states.GetSize())
+			{
+				throw std::invalid_argument("Failed to read Moore table. Row size doesn't match states count");
 			}
-			m_mooreTable.emplace_back(std::move(stateRow));
 		}
+
+		m_targets = TransitionMatrix{ m_transitions.GetSize(), m_states.GetSize(), std::move(targets) };
 	}
 
-	csv::CSVReader& m_reader;
+	TableScanner m_scanner;
 
-	Signals m_signals;
-	States m_states;
-	Transitions m_transitions;
-	MooreStatesTable m_mooreTable;
+	SymbolTable m_signals;
+	StateSignals m_stateSignals;
+	SymbolTable m_states;
+	SymbolTable m_transitions;
+	TransitionMatrix m_targets;
 };
 
 #endif // !AUTOMATA_MOORE_TABLE_READER_HPP_
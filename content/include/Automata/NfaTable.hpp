@@ -0,0 +1,146 @@
+#ifndef AUTOMATA_NFA_TABLE_HPP_
+#define AUTOMATA_NFA_TABLE_HPP_
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "SymbolTable.hpp"
+
+namespace nfa_excps
+{
+
+constexpr auto WRONG_OFFSETS_MSG = "Failed to construct NFA targets. Offsets don't match cells count";
+constexpr auto WRONG_TARGET_MSG = "Failed to construct NFA targets. Target state is out of range";
+constexpr auto WRONG_TARGETS_SIZE_MSG = "Failed to construct NFA table. Targets size doesn't match table size";
+constexpr auto WRONG_TAGS_SIZE_MSG = "Failed to construct NFA table. Accept tags count doesn't match states count";
+
+}; // namespace nfa_excps
+
+// Sets of targets of cells (row, state) stored one after another in row-major order:
+// targets of cell i are m_targets[m_offsets[i]..m_offsets[i + 1])
+class NfaTargets
+{
+public:
+	using Id = SymbolTable::Id;
+	using Ids = std::vector<Id>;
+
+	NfaTargets() = default;
+
+	NfaTargets(size_t rowsCount, size_t statesCount, Ids&& offsets, Ids&& targets)
+		: m_rowsCount(rowsCount)
+		, m_statesCount(statesCount)
+		, m_offsets(std::move(offsets))
+		, m_targets(std::move(targets))
+	{
+		if (m_offsets.size() != rowsCount * statesCount + 1
+			|| m_offsets.front() != 0
+			|| m_offsets.back() != m_targets.size())
+		{
+			throw std::invalid_argument(nfa_excps::WRONG_OFFSETS_MSG);
+		}
+		for (auto target : m_targets)
+		{
+			if (target >= statesCount)
+			{
+				throw std::out_of_range(nfa_excps::WRONG_TARGET_MSG);
+			}
+		}
+	}
+
+	// Table where every cell has no targets
+	NfaTargets(size_t rowsCount, size_t statesCount)
+		: NfaTargets(rowsCount, statesCount, Ids(rowsCount * statesCount + 1), Ids{})
+	{
+	}
+
+	std::span<const Id> At(size_t row, size_t state) const noexcept
+	{
+		auto cell = row * m_statesCount + state;
+		return { m_targets.data() + m_offsets[cell], m_targets.data() + m_offsets[cell + 1] };
+	}
+
+	size_t GetRowsCount() const noexcept
+	{
+		return m_rowsCount;
+	}
+
+	size_t GetStatesCount() const noexcept
+	{
+		return m_statesCount;
+	}
+
+private:
+	size_t m_rowsCount{};
+	size_t m_statesCount{};
+	Ids m_offsets{ 0 };
+	Ids m_targets{};
+};
+
+// Nondeterministic automaton. State 0 is the start one. Every state has an accept tag:
+// 0 for non-final states, otherwise the accepted token, where lower tag has higher priority
+class NfaTable
+{
+public:
+	using AcceptTags = std::vector<std::uint32_t>;
+
+	NfaTable(const SymbolTable& states,
+		const SymbolTable& transitions,
+		const AcceptTags& acceptTags,
+		const NfaTargets& targets,
+		const NfaTargets& epsilonTargets)
+		: m_states(states)
+		, m_transitions(transitions)
+		, m_acceptTags(acceptTags)
+		, m_targets(targets)
+		, m_epsilonTargets(epsilonTargets)
+	{
+		if (m_acceptTags.size() != m_states.GetSize())
+		{
+			throw std::invalid_argument(nfa_excps::WRONG_TAGS_SIZE_MSG);
+		}
+		if (m_targets.GetRowsCount() != m_transitions.GetSize()
+			|| m_targets.GetStatesCount() != m_states.GetSize()
+			|| m_epsilonTargets.GetRowsCount() != 1
+			|| m_epsilonTargets.GetStatesCount() != m_states.GetSize())
+		{
+			throw std::invalid_argument(nfa_excps::WRONG_TARGETS_SIZE_MSG);
+		}
+	}
+
+	const SymbolTable& GetStates() const noexcept
+	{
+		return m_states;
+	}
+
+	const SymbolTable& GetTransitions() const noexcept
+	{
+		return m_transitions;
+	}
+
+	const AcceptTags& GetAcceptTags() const noexcept
+	{
+		return m_acceptTags;
+	}
+
+	const NfaTargets& GetTargets() const noexcept
+	{
+		return m_targets;
+	}
+
+	// Single row of targets reached without consuming input
+	const NfaTargets& GetEpsilonTargets() const noexcept
+	{
+		return m_epsilonTargets;
+	}
+
+private:
+	SymbolTable m_states;
+	SymbolTable m_transitions;
+	AcceptTags m_acceptTags;
+	NfaTargets m_targets;
+	NfaTargets m_epsilonTargets;
+};
+
+#endif // !AUTOMATA_NFA_TABLE_HPP_
@@ -0,0 +1,182 @@
+#ifndef AUTOMATA_NFA_TABLE_READER_HPP_
+#define AUTOMATA_NFA_TABLE_READER_HPP_
+
+#include <string_view>
+#include <vector>
+
+#include "NfaTable.hpp"
+#include "State.hpp"
+#include "SymbolTable.hpp"
+#include "TableScanner.hpp"
+
+// Reads NFA table:
+//   ;F;;F          final states are marked with F
+//   ;q0;q1;q2      states, the first one is the start state
+//   x1;q0,q1;;q2   comma-separated targets by input, empty cell has no targets
+//   ε;q1;;         optional row of epsilon transitions
+class NfaTableReader
+{
+public:
+	static constexpr std::string_view FINAL_MARK = "F";
+	static constexpr std::string_view EPSILON = "ε";
+	static constexpr char TARGETS_DELIMETER = ',';
+
+	NfaTableReader(std::string_view content)
+		: m_scanner(content)
+		, m_states()
+		, m_transitions()
+		, m_acceptTags()
+		, m_targets()
+		, m_epsilonTargets()
+	{
+		auto finalMarks = ReadHeaderLine();
+		ReadStates();
+		ReadAcceptTags(finalMarks);
+		ReadRows();
+	}
+
+	const SymbolTable& GetStates() const
+	{
+		return m_states;
+	}
+
+	const SymbolTable& GetTransitions() const
+	{
+		return m_transitions;
+	}
+
+	const NfaTable::AcceptTags& GetAcceptTags() const
+	{
+		return m_acceptTags;
+	}
+
+	const NfaTargets& GetTargets() const
+	{
+		return m_targets;
+	}
+
+	const NfaTargets& GetEpsilonTargets() const
+	{
+		return m_epsilonTargets;
+	}
+
+private:
+	std::string_view ReadHeaderLine()
+	{
+		std::string_view line{};
+		if (!m_scanner.ReadLine(line))
+		{
+			throw std::invalid_argument("Failed to read NFA table. Table must start with final marks and states lines");
+		}
+
+		return line;
+	}
+
+	void ReadStates()
+	{
+		std::string_view fieldContent{};
+		for (FieldsRange fields{ ReadHeaderLine() }; fields.Next(fieldContent);)
+		{
+			if (!fieldContent.empty())
+			{
+				ThrowIfFailed(CheckSignalName(fieldContent));
+				m_states.InternUnique(fieldContent);
+			}
+		}
+	}
+
+	void ReadAcceptTags(std::string_view finalMarks)
+	{
+		FieldsRange fields{ finalMarks };
+		std::string_view mark{};
+		fields.Next(mark);
+
+		for (; fields.Next(mark);)
+		{
+			if (!mark.empty() && mark != FINAL_MARK)
+			{
+				throw std::invalid_argument("Failed to read NFA table. Unknown final mark " + std::string(mark));
+			}
+			m_acceptTags.push_back(mark.empty() ? 0 : 1);
+		}
+
+		if (m_acceptTags.size() > m_states.GetSize())
+		{
+			throw std::invalid_argument("Failed to read NFA table. Final marks count exceeds states count");
+		}
+		m_acceptTags.resize(m_states.GetSize());
+	}
+
+	void ReadTargets(std::string_view cell, NfaTargets::Ids& targets)
+	{
+		while (!cell.empty())
+		{
+			auto nameEnd = cell.find(TARGETS_DELIMETER);
+			auto stateName = cell.substr(0, nameEnd);
+			cell.remove_prefix(nameEnd == cell.npos ? cell.size() : nameEnd + 1);
+
+			auto target = m_states.FindId(stateName);
+			if (!target)
+			{
+				throw std::out_of_range("NFA table doesn't contain transition's target state " + std::string(stateName));
+			}
+			targets.push_back(*target);
+		}
+	}
+
+	void ReadRows()
+	{
+		NfaTargets::Ids offsets{ 0 };
+		NfaTargets::Ids targets{};
+		NfaTargets::Ids epsilonOffsets{ 0 };
+		NfaTargets::Ids epsilonTargets{};
+
+		for (std::string_view line{}; m_scanner.ReadLine(line);)
+		{
+			FieldsRange fields{ line };
+
+			std::string_view transition{};
+			fields.Next(transition);
+
+			auto isEpsilon = transition == EPSILON;
+			if (isEpsilon && epsilonOffsets.size() != 1)
+			{
+				throw std::invalid_argument("Failed to read NFA table. Table contains more than one epsilon row");
+			}
+			if (!isEpsilon)
+			{
+				ThrowIfFailed(CheckSignalName(transition));
+				m_transitions.InternUnique(transition);
+			}
+
+			auto& rowOffsets = isEpsilon ? epsilonOffsets : offsets;
+			auto& rowTargets = isEpsilon ? epsilonTargets : targets;
+			size_t fieldsCount = 0;
+			for (std::string_view cell{}; fields.Next(cell); ++fieldsCount)
+			{
+				ReadTargets(cell, rowTargets);
+				rowOffsets.push_back(static_cast<NfaTargets::Id>(rowTargets.size()));
+			}
+
+			if (fieldsCount != m_states.GetSize())
+			{
+				throw std::invalid_argument("Failed to read NFA table. Row size doesn't match states count");
+			}
+		}
+
+		m_targets = NfaTargets{ m_transitions.GetSize(), m_states.GetSize(), std::move(offsets), std::move(targets) };
+		m_epsilonTargets = epsilonOffsets.size() == 1
+			? NfaTargets{ 1, m_states.GetSize() }
+			: NfaTargets{ 1, m_states.GetSize(), std::move(epsilonOffsets), std::move(epsilonTargets) };
+	}
+
+	TableScanner m_scanner;
+
+	SymbolTable m_states;
+	SymbolTable m_transitions;
+	NfaTable::AcceptTags m_acceptTags;
+	NfaTargets m_targets;
+	NfaTargets m_epsilonTargets;
+};
+
+#endif // !AUTOMATA_NFA_TABLE_READER_HPP_
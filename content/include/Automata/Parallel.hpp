@@ -0,0 +1,366 @@
+#ifndef AUTOMATA_PARALLEL_HPP_
+#define AUTOMATA_PARALLEL_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Threads count to use when user asked for 0 threads
+inline size_t GetDefaultThreadsCount() noexcept
+{
+	auto count = std::thread::hardware_concurrency();
+	return count == 0 ? 1 : count;
+}
+
+// Splits [0, size) into threadsCount contiguous ranges and runs fn(begin, end, rangeIndex) for each of them
+// on its own thread. The calling thread takes the first range. Rethrows the first exception thrown by fn
+template <typename Fn>
+void ParallelFor(size_t threadsCount, size_t size, Fn&& fn)
+{
+	threadsCount = std::max<size_t>(1, std::min(threadsCount, size));
+	if (threadsCount == 1)
+	{
+		fn(size_t{}, size, size_t{});
+		return;
+	}
+
+	std::vector<std::exception_ptr> errors(threadsCount);
+	auto runRange = [&](size_t rangeIndex) {
+		try
+		{
+			fn(size * rangeIndex / threadsCount, size * (rangeIndex + 1) / threadsCount, rangeIndex);
+		}
+		catch (...)
+		{
+			errors[rangeIndex] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads{};
+	threads.reserve(threadsCount - 1);
+	for (size_t rangeIndex = 1; rangeIndex < threadsCount; ++rangeIndex)
+	{
+		threads.emplace_back(runRange, rangeIndex);
+	}
+	runRange(0);
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	for (auto& error : errors)
+	{
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+// Threads kept alive between parallel loops, so rounds of an algorithm don't start new threads.
+// Run(size, fn) works as ParallelFor on the pool's threads, the calling thread takes the first range
+class WorkerPool
+{
+public:
+	explicit WorkerPool(size_t threadsCount)
+		: m_threadsCount(std::max<size_t>(1, threadsCount))
+		, m_mutex()
+		, m_wakeUp()
+		, m_done()
+		, m_task()
+		, m_generation()
+		, m_pendingCount()
+		, m_isStopping(false)
+		, m_errors(m_threadsCount)
+		, m_threads()
+	{
+		m_threads.reserve(m_threadsCount - 1);
+		try
+		{
+			for (size_t worker = 1; worker < m_threadsCount; ++worker)
+			{
+				m_threads.emplace_back([this, worker] { RunWorker(worker); });
+			}
+		}
+		catch (...)
+		{
+			Stop();
+			throw;
+		}
+	}
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	~WorkerPool()
+	{
+		Stop();
+	}
+
+	size_t GetThreadsCount() const noexcept
+	{
+		return m_threadsCount;
+	}
+
+	// Splits [0, size) into at most GetThreadsCount() contiguous ranges and runs fn(begin, end, rangeIndex)
+	// for each of them. Ranges depend only on size, so loops of the same size get the same ranges.
+	// Rethrows the first exception thrown by fn
+	template <typename Fn>
+	void Run(size_t size, Fn&& fn)
+	{
+		auto rangesCount = std::max<size_t>(1, std::min(m_threadsCount, size));
+		if (rangesCount == 1)
+		{
+			fn(size_t{}, size, size_t{});
+			return;
+		}
+
+		{
+			std::lock_guard lock{ m_mutex };
+			m_task = [&fn, size, rangesCount](size_t rangeIndex) {
+				if (rangeIndex < rangesCount)
+				{
+					fn(size * rangeIndex / rangesCount, size * (rangeIndex + 1) / rangesCount, rangeIndex);
+				}
+			};
+			std::fill(m_errors.begin(), m_errors.end(), nullptr);
+			m_pendingCount = m_threads.size();
+			++m_generation;
+		}
+		m_wakeUp.notify_all();
+
+		RunTask(0);
+		{
+			std::unique_lock lock{ m_mutex };
+			m_done.wait(lock, [this] { return m_pendingCount == 0; });
+			m_task = nullptr;
+		}
+
+		for (auto& error : m_errors)
+		{
+			if (error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+private:
+	void RunTask(size_t worker) noexcept
+	{
+		try
+		{
+			m_task(worker);
+		}
+		catch (...)
+		{
+			m_errors[worker] = std::current_exception();
+		}
+	}
+
+	void RunWorker(size_t worker)
+	{
+		std::uint64_t seenGeneration = 0;
+		while (true)
+		{
+			{
+				std::unique_lock lock{ m_mutex };
+				m_wakeUp.wait(lock, [&] { return m_isStopping || m_generation != seenGeneration; });
+				if (m_isStopping)
+				{
+					return;
+				}
+				seenGeneration = m_generation;
+			}
+
+			RunTask(worker);
+
+			std::lock_guard lock{ m_mutex };
+			if (--m_pendingCount == 0)
+			{
+				m_done.notify_one();
+			}
+		}
+	}
+
+	void Stop() noexcept
+	{
+		{
+			std::lock_guard lock{ m_mutex };
+			m_isStopping = true;
+		}
+		m_wakeUp.notify_all();
+		for (auto& thread : m_threads)
+		{
+			thread.join();
+		}
+		m_threads.clear();
+	}
+
+	size_t m_threadsCount;
+	std::mutex m_mutex;
+	std::condition_variable m_wakeUp;
+	std::condition_variable m_done;
+	std::function<void(size_t)> m_task;
+	std::uint64_t m_generation;
+	size_t m_pendingCount;
+	bool m_isStopping;
+	std::vector<std::exception_ptr> m_errors;
+	std::vector<std::thread> m_threads;
+};
+
+// Sorts ranges of the vector on the pool's threads and merges them pairwise, also in parallel
+template <typename T, typename Compare>
+void ParallelSort(WorkerPool& pool, std::vector<T>& items, Compare compare)
+{
+	auto rangesCount = std::max<size_t>(1, std::min(pool.GetThreadsCount(), items.size()));
+
+	std::vector<size_t> bounds(rangesCount + 1);
+	for (size_t i = 0; i <= rangesCount; ++i)
+	{
+		bounds[i] = items.size() * i / rangesCount;
+	}
+
+	pool.Run(rangesCount, [&](size_t begin, size_t end, size_t) {
+		for (auto range = begin; range < end; ++range)
+		{
+			std::sort(items.begin() + bounds[range], items.begin() + bounds[range + 1], compare);
+		}
+	});
+
+	for (size_t width = 1; width < rangesCount; width *= 2)
+	{
+		auto mergesCount = (rangesCount + 2 * width - 1) / (2 * width);
+		pool.Run(mergesCount, [&](size_t begin, size_t end, size_t) {
+			for (auto merge = begin; merge < end; ++merge)
+			{
+				auto first = merge * 2 * width;
+				auto middle = std::min(first + width, rangesCount);
+				auto last = std::min(first + 2 * width, rangesCount);
+				if (middle < last)
+				{
+					std::inplace_merge(items.begin() + bounds[first],
+						items.begin() + bounds[middle],
+						items.begin() + bounds[last],
+						compare);
+				}
+			}
+		});
+	}
+}
+
+// Runs fn(index) for every index of [0, size) on threadsCount threads, for items of uneven cost.
+// Every thread starts with its own contiguous share and takes items from its front. A thread whose
+// share is over steals the back half of the largest share left, so no thread idles while work remains.
+// Rethrows the first exception thrown by fn after all items are done
+template <typename Fn>
+void ParallelForEach(size_t threadsCount, size_t size, Fn&& fn)
+{
+	threadsCount = std::max<size_t>(1, std::min(threadsCount, size));
+
+	struct Share
+	{
+		std::mutex m_mutex;
+		size_t m_begin{};
+		size_t m_end{};
+	};
+	std::vector<Share> shares(threadsCount);
+	for (size_t i = 0; i < threadsCount; ++i)
+	{
+		shares[i].m_begin = size * i / threadsCount;
+		shares[i].m_end = size * (i + 1) / threadsCount;
+	}
+
+	auto takeOwn = [&](Share& share, size_t& index) {
+		std::lock_guard lock{ share.m_mutex };
+		if (share.m_begin == share.m_end)
+		{
+			return false;
+		}
+		index = share.m_begin++;
+		return true;
+	};
+
+	auto steal = [&](Share& own) {
+		while (true)
+		{
+			Share* victim = nullptr;
+			size_t victimSize = 0;
+			for (auto& share : shares)
+			{
+				std::lock_guard lock{ share.m_mutex };
+				if (share.m_end - share.m_begin > victimSize)
+				{
+					victim = &share;
+					victimSize = share.m_end - share.m_begin;
+				}
+			}
+			if (victim == nullptr)
+			{
+				return false;
+			}
+
+			std::scoped_lock lock{ victim->m_mutex, own.m_mutex };
+			auto left = victim->m_end - victim->m_begin;
+			if (left == 0)
+			{
+				continue;
+			}
+			auto middle = victim->m_end - (left + 1) / 2;
+			own.m_begin = middle;
+			own.m_end = victim->m_end;
+			victim->m_end = middle;
+			return true;
+		}
+	};
+
+	std::vector<std::exception_ptr> errors(threadsCount);
+	auto runWorker = [&](size_t worker) {
+		auto& own = shares[worker];
+		size_t index{};
+		do
+		{
+			while (takeOwn(own, index))
+			{
+				try
+				{
+					fn(index);
+				}
+				catch (...)
+				{
+					if (!errors[worker])
+					{
+						errors[worker] = std::current_exception();
+					}
+				}
+			}
+		} while (steal(own));
+	};
+
+	std::vector<std::thread> threads{};
+	threads.reserve(threadsCount - 1);
+	for (size_t worker = 1; worker < threadsCount; ++worker)
+	{
+		threads.emplace_back(runWorker, worker);
+	}
+	runWorker(0);
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	for (auto& error : errors)
+	{
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+#endif // !AUTOMATA_PARALLEL_HPP_
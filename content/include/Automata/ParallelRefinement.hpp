@@ -0,0 +1,300 @@
+#ifndef AUTOMATA_PARALLEL_REFINEMENT_HPP_
+#define AUTOMATA_PARALLEL_REFINEMENT_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Parallel.hpp"
+#include "PartitionRefinement.hpp"
+
+// Partition refinement by rounds for huge tables. Every round computes a signature of each state:
+// its current class and classes of its successors by every input. Hashes of signatures are computed
+// in parallel over ranges of states, then states are sorted by hash in parallel and neighbours with
+// equal signatures get the same new class. Rounds stop when the number of classes stops growing.
+// All rounds run on one pool of threads. Results are the same as of HopcroftPartition
+class ParallelPartition
+{
+public:
+	using Transitions = HopcroftPartition::Transitions;
+	using Classes = HopcroftPartition::Classes;
+
+	ParallelPartition(size_t statesCount,
+		size_t inputsCount,
+		const Transitions& transitions,
+		const Classes& initialClasses,
+		size_t threadsCount)
+		: m_statesCount(statesCount)
+		, m_inputsCount(inputsCount)
+		, m_threadsCount(std::max<size_t>(1, threadsCount))
+		, m_transitions(transitions)
+		, m_classes()
+		, m_classesCount()
+		, m_roundsCount()
+	{
+		if (transitions.size() != statesCount * inputsCount)
+		{
+			throw std::invalid_argument(partition_excps::WRONG_TRANSITIONS_SIZE_MSG);
+		}
+		if (initialClasses.size() != statesCount)
+		{
+			throw std::invalid_argument(partition_excps::WRONG_CLASSES_SIZE_MSG);
+		}
+		if (std::any_of(transitions.begin(), transitions.end(), [statesCount](auto target) { return target >= statesCount; }))
+		{
+			throw std::out_of_range(partition_excps::WRONG_TARGET_MSG);
+		}
+
+		m_classes = Renumber(initialClasses);
+		Refine();
+	}
+
+	// Class of every state. Classes are numbered in order of their first state,
+	// so state 0 always belongs to class 0
+	Classes GetClasses() const
+	{
+		return Classes(m_classes.begin(), m_classes.end());
+	}
+
+	size_t GetClassesCount() const noexcept
+	{
+		return m_classesCount;
+	}
+
+	size_t GetRoundsCount() const noexcept
+	{
+		return m_roundsCount;
+	}
+
+private:
+	struct HashedState
+	{
+		std::uint64_t m_hash;
+		std::uint32_t m_state;
+	};
+
+	static std::vector<std::uint32_t> Renumber(const Classes& classes)
+	{
+		constexpr auto unnumbered = static_cast<std::uint32_t>(-1);
+
+		std::vector<std::uint32_t> result(classes.size());
+		std::vector<std::uint32_t> classToNumber{};
+		std::uint32_t nextNumber{};
+		for (size_t state = 0; state < classes.size(); ++state)
+		{
+			if (classes[state] >= classToNumber.size())
+			{
+				classToNumber.resize(classes[state] + 1, unnumbered);
+			}
+			auto& number = classToNumber[classes[state]];
+			if (number == unnumbered)
+			{
+				number = nextNumber++;
+			}
+			result[state] = number;
+		}
+
+		return result;
+	}
+
+	// Calls fn(i, countBefore) for every i of [0, size), where countBefore is the count of flagged
+	// indexes less than i. Counts of ranges are summed by a prefix sum, so both passes are parallel.
+	// Returns the count of all flagged indexes
+	template <typename Fn>
+	static size_t ForEachWithFlagsCount(WorkerPool& pool, const std::vector<char>& flags, Fn&& fn)
+	{
+		std::vector<size_t> rangeOffsets(pool.GetThreadsCount() + 1);
+		pool.Run(flags.size(), [&](size_t begin, size_t end, size_t rangeIndex) {
+			rangeOffsets[rangeIndex + 1] = static_cast<size_t>(std::count(flags.begin() + begin, flags.begin() + end, char{ true }));
+		});
+		for (size_t i = 1; i < rangeOffsets.size(); ++i)
+		{
+			rangeOffsets[i] += rangeOffsets[i - 1];
+		}
+
+		pool.Run(flags.size(), [&](size_t begin, size_t end, size_t rangeIndex) {
+			auto count = rangeOffsets[rangeIndex];
+			for (auto i = begin; i < end; ++i)
+			{
+				fn(i, count);
+				count += flags[i] ? 1 : 0;
+			}
+		});
+
+		return rangeOffsets.back();
+	}
+
+	bool HaveEqualSignatures(std::uint32_t lhs, std::uint32_t rhs) const noexcept
+	{
+		if (m_classes[lhs] != m_classes[rhs])
+		{
+			return false;
+		}
+		for (size_t input = 0; input < m_inputsCount; ++input)
+		{
+			auto row = m_transitions.data() + input * m_statesCount;
+			if (m_classes[row[lhs]] != m_classes[row[rhs]])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Flags first entries of new classes among entries [begin, end) of order with equal hashes.
+	// If hashes of different signatures collide, entries are reordered by signature, then by state
+	void MarkClassStarts(std::vector<HashedState>& order, std::vector<char>& isClassStart, size_t begin, size_t end) const
+	{
+		auto hasCollision = false;
+		isClassStart[begin] = true;
+		for (auto i = begin + 1; i < end; ++i)
+		{
+			isClassStart[i] = false;
+			hasCollision = hasCollision || !HaveEqualSignatures(order[i].m_state, order[begin].m_state);
+		}
+		if (!hasCollision)
+		{
+			return;
+		}
+
+		std::vector<std::uint32_t> representatives{};
+		std::vector<std::pair<size_t, std::uint32_t>> signatures{};
+		for (auto i = begin; i < end; ++i)
+		{
+			auto state = order[i].m_state;
+			auto representative = std::find_if(representatives.begin(), representatives.end(), [&](auto other) {
+				return HaveEqualSignatures(other, state);
+			});
+			if (representative == representatives.end())
+			{
+				representative = representatives.insert(representatives.end(), state);
+			}
+			signatures.emplace_back(static_cast<size_t>(representative - representatives.begin()), state);
+		}
+		std::sort(signatures.begin(), signatures.end());
+
+		for (size_t i = 0; i < signatures.size(); ++i)
+		{
+			order[begin + i].m_state = signatures[i].second;
+			isClassStart[begin + i] = i == 0 || signatures[i].first != signatures[i - 1].first;
+		}
+	}
+
+	void Refine()
+	{
+		m_classesCount = m_statesCount == 0
+			? 0
+			: *std::max_element(m_classes.begin(), m_classes.end()) + 1;
+		if (m_classesCount == m_statesCount)
+		{
+			return;
+		}
+
+		WorkerPool pool{ std::min(m_threadsCount, m_statesCount) };
+		std::vector<HashedState> order(m_statesCount);
+		std::vector<char> isClassStart(m_statesCount);
+		std::vector<std::uint32_t> newClasses(m_statesCount);
+		while (true)
+		{
+			++m_roundsCount;
+
+			pool.Run(m_statesCount, [&](size_t begin, size_t end, size_t) {
+				for (auto state = begin; state < end; ++state)
+				{
+					order[state] = HashedState{ MixHash(m_classes[state]), static_cast<std::uint32_t>(state) };
+				}
+				for (size_t input = 0; input < m_inputsCount; ++input)
+				{
+					auto row = m_transitions.data() + input * m_statesCount;
+					for (auto state = begin; state < end; ++state)
+					{
+						order[state].m_hash = MixHash(order[state].m_hash ^ (m_classes[row[state]] + 0x9e3779b97f4a7c15ULL));
+					}
+				}
+			});
+
+			ParallelSort(pool, order, [](const HashedState& lhs, const HashedState& rhs) {
+				return lhs.m_hash != rhs.m_hash ? lhs.m_hash < rhs.m_hash : lhs.m_state < rhs.m_state;
+			});
+
+			// A range handles the groups of equal hashes that start in it, to their ends
+			pool.Run(m_statesCount, [&](size_t begin, size_t end, size_t) {
+				auto groupBegin = begin;
+				while (groupBegin < end && groupBegin != 0 && order[groupBegin].m_hash == order[groupBegin - 1].m_hash)
+				{
+					++groupBegin;
+				}
+				while (groupBegin < end)
+				{
+					auto groupEnd = groupBegin + 1;
+					while (groupEnd < m_statesCount && order[groupEnd].m_hash == order[groupBegin].m_hash)
+					{
+						++groupEnd;
+					}
+					MarkClassStarts(order, isClassStart, groupBegin, groupEnd);
+					groupBegin = groupEnd;
+				}
+			});
+
+			auto newClassesCount = ForEachWithFlagsCount(pool, isClassStart, [&](size_t i, size_t startsBefore) {
+				newClasses[order[i].m_state] = static_cast<std::uint32_t>(startsBefore + (isClassStart[i] ? 1 : 0) - 1);
+			});
+
+			std::swap(m_classes, newClasses);
+			if (newClassesCount == m_classesCount || newClassesCount == m_statesCount)
+			{
+				m_classesCount = newClassesCount;
+				break;
+			}
+			m_classesCount = newClassesCount;
+		}
+
+		NumberByFirstStates(pool, order, isClassStart);
+	}
+
+	// Renumbers classes of the last round in order of their first states. Entries of a class are
+	// neighbours in order, sorted by state, so the first entry of a class is its first state
+	void NumberByFirstStates(WorkerPool& pool, const std::vector<HashedState>& order, const std::vector<char>& isClassStart)
+	{
+		std::vector<char> isFirstState(m_statesCount);
+		pool.Run(m_statesCount, [&](size_t begin, size_t end, size_t) {
+			for (auto i = begin; i < end; ++i)
+			{
+				if (isClassStart[i])
+				{
+					isFirstState[order[i].m_state] = true;
+				}
+			}
+		});
+
+		std::vector<std::uint32_t> classToNumber(m_classesCount);
+		ForEachWithFlagsCount(pool, isFirstState, [&](size_t state, size_t firstStatesBefore) {
+			if (isFirstState[state])
+			{
+				classToNumber[m_classes[state]] = static_cast<std::uint32_t>(firstStatesBefore);
+			}
+		});
+
+		pool.Run(m_statesCount, [&](size_t begin, size_t end, size_t) {
+			for (auto state = begin; state < end; ++state)
+			{
+				m_classes[state] = classToNumber[m_classes[state]];
+			}
+		});
+	}
+
+	size_t m_statesCount;
+	size_t m_inputsCount;
+	size_t m_threadsCount;
+	std::span<const std::uint32_t> m_transitions;
+
+	std::vector<std::uint32_t> m_classes;
+	size_t m_classesCount;
+	size_t m_roundsCount;
+};
+
+#endif // !AUTOMATA_PARALLEL_REFINEMENT_HPP_
@@ -0,0 +1,303 @@
+#ifndef AUTOMATA_PARTITION_REFINEMENT_HPP_
+#define AUTOMATA_PARTITION_REFINEMENT_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace partition_excps
+{
+
+constexpr auto WRONG_TRANSITIONS_SIZE_MSG = "Failed to refine partition. Transitions must contain statesCount * inputsCount targets";
+constexpr auto WRONG_CLASSES_SIZE_MSG = "Failed to refine partition. Initial classes must contain statesCount entries";
+constexpr auto WRONG_TARGET_MSG = "Failed to refine partition. Transition's target is out of range";
+
+}; // namespace partition_excps
+
+// Mixes bits of a 64-bit value, a step of hashing signatures and columns of states
+inline std::uint64_t MixHash(std::uint64_t value) noexcept
+{
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9ULL;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111ebULL;
+	value ^= value >> 31;
+	return value;
+}
+
+// Hopcroft's partition refinement over a complete deterministic transition function.
+// Transitions are stored input-major: transitions[input * statesCount + state] is the target of state by input.
+// Blocks of the initial partition are split until none of them can be told apart by any (block, input) splitter.
+class HopcroftPartition
+{
+public:
+	using Transitions = std::vector<std::uint32_t>;
+	using Classes = std::vector<size_t>;
+
+	HopcroftPartition(size_t statesCount,
+		size_t inputsCount,
+		const Transitions& transitions,
+		const Classes& initialClasses)
+		: m_statesCount(statesCount)
+		, m_inputsCount(inputsCount)
+		, m_splittersCount()
+	{
+		if (transitions.size() != statesCount * inputsCount)
+		{
+			throw std::invalid_argument(partition_excps::WRONG_TRANSITIONS_SIZE_MSG);
+		}
+		if (initialClasses.size() != statesCount)
+		{
+			throw std::invalid_argument(partition_excps::WRONG_CLASSES_SIZE_MSG);
+		}
+
+		BuildPredecessors(transitions);
+		BuildInitialBlocks(initialClasses);
+		Refine();
+	}
+
+	// Class of every state. Classes are numbered in order of their first state,
+	// so state 0 always belongs to class 0
+	Classes GetClasses() const
+	{
+		constexpr auto unnumbered = static_cast<size_t>(-1);
+
+		Classes result(m_statesCount);
+		std::vector<size_t> blockToClass(m_blockBegin.size(), unnumbered);
+
+		size_t nextClass{};
+		for (size_t state = 0; state < m_statesCount; ++state)
+		{
+			auto& classIndex = blockToClass[m_blockOf[state]];
+			if (classIndex == unnumbered)
+			{
+				classIndex = nextClass++;
+			}
+			result[state] = classIndex;
+		}
+
+		return result;
+	}
+
+	size_t GetClassesCount() const noexcept
+	{
+		return m_blockBegin.size();
+	}
+
+	// Count of (block, input) splitters taken from the worklist, the work done by refinement
+	size_t GetSplittersCount() const noexcept
+	{
+		return m_splittersCount;
+	}
+
+private:
+	void BuildPredecessors(const Transitions& transitions)
+	{
+		const auto cellsCount = m_statesCount * m_inputsCount;
+
+		m_predecessorsOffsets.assign(cellsCount + 1, 0);
+		for (size_t input = 0; input < m_inputsCount; ++input)
+		{
+			for (size_t state = 0; state < m_statesCount; ++state)
+			{
+				auto target = transitions[input * m_statesCount + state];
+				if (target >= m_statesCount)
+				{
+					throw std::out_of_range(partition_excps::WRONG_TARGET_MSG);
+				}
+				++m_predecessorsOffsets[input * m_statesCount + target + 1];
+			}
+		}
+		for (size_t i = 1; i <= cellsCount; ++i)
+		{
+			m_predecessorsOffsets[i] += m_predecessorsOffsets[i - 1];
+		}
+
+		m_predecessors.resize(cellsCount);
+		std::vector<size_t> fillPositions(m_predecessorsOffsets.begin(), m_predecessorsOffsets.end() - 1);
+		for (size_t input = 0; input < m_inputsCount; ++input)
+		{
+			for (size_t state = 0; state < m_statesCount; ++state)
+			{
+				auto target = transitions[input * m_statesCount + state];
+				m_predecessors[fillPositions[input * m_statesCount + target]++] = static_cast<std::uint32_t>(state);
+			}
+		}
+	}
+
+	void BuildInitialBlocks(const Classes& initialClasses)
+	{
+		constexpr auto unnumbered = static_cast<size_t>(-1);
+
+		auto maxClass = initialClasses.empty()
+			? size_t{}
+			: *std::max_element(initialClasses.begin(), initialClasses.end());
+		std::vector<size_t> classToBlock(initialClasses.empty() ? 0 : maxClass + 1, unnumbered);
+
+		m_blockOf.resize(m_statesCount);
+		std::vector<size_t> blockSizes{};
+		for (size_t state = 0; state < m_statesCount; ++state)
+		{
+			auto& block = classToBlock[initialClasses[state]];
+			if (block == unnumbered)
+			{
+				block = blockSizes.size();
+				blockSizes.push_back(0);
+			}
+			m_blockOf[state] = block;
+			++blockSizes[block];
+		}
+
+		m_blockBegin.resize(blockSizes.size());
+		m_blockEnd.resize(blockSizes.size());
+		size_t offset{};
+		for (size_t block = 0; block < blockSizes.size(); ++block)
+		{
+			m_blockBegin[block] = offset;
+			offset += blockSizes[block];
+			m_blockEnd[block] = m_blockBegin[block];
+		}
+
+		m_elements.resize(m_statesCount);
+		m_positions.resize(m_statesCount);
+		for (size_t state = 0; state < m_statesCount; ++state)
+		{
+			auto position = m_blockEnd[m_blockOf[state]]++;
+			m_elements[position] = state;
+			m_positions[state] = position;
+		}
+		m_markedEnd = m_blockBegin;
+
+		// Every state has a successor in the union of all blocks, so splitting by one
+		// of the initial blocks is implied by the others: the largest one is left out
+		m_isPending.assign(m_blockBegin.size() * m_inputsCount, false);
+		auto largestIt = std::max_element(blockSizes.begin(), blockSizes.end());
+		auto largest = static_cast<size_t>(std::distance(blockSizes.begin(), largestIt));
+		for (size_t block = 0; block < m_blockBegin.size(); ++block)
+		{
+			if (block == largest)
+			{
+				continue;
+			}
+			for (size_t input = 0; input < m_inputsCount; ++input)
+			{
+				AddSplitter(block, input);
+			}
+		}
+	}
+
+	void Refine()
+	{
+		while (!m_pending.empty())
+		{
+			auto [splitter, input] = m_pending.back();
+			m_pending.pop_back();
+			m_isPending[splitter * m_inputsCount + input] = false;
+			++m_splittersCount;
+
+			for (auto i = m_blockBegin[splitter]; i < m_blockEnd[splitter]; ++i)
+			{
+				auto cell = input * m_statesCount + m_elements[i];
+				m_touchedStates.insert(m_touchedStates.end(),
+					m_predecessors.begin() + m_predecessorsOffsets[cell],
+					m_predecessors.begin() + m_predecessorsOffsets[cell + 1]);
+			}
+
+			for (auto state : m_touchedStates)
+			{
+				Mark(state);
+			}
+			for (auto block : m_touchedBlocks)
+			{
+				Split(block);
+			}
+
+			m_touchedStates.clear();
+			m_touchedBlocks.clear();
+		}
+	}
+
+	void Mark(size_t state)
+	{
+		auto block = m_blockOf[state];
+		auto position = m_positions[state];
+		if (position < m_markedEnd[block])
+		{
+			return;
+		}
+		if (m_markedEnd[block] == m_blockBegin[block])
+		{
+			m_touchedBlocks.push_back(block);
+		}
+
+		auto swapPosition = m_markedEnd[block]++;
+		auto swapState = m_elements[swapPosition];
+		std::swap(m_elements[position], m_elements[swapPosition]);
+		m_positions[swapState] = position;
+		m_positions[state] = swapPosition;
+	}
+
+	void Split(size_t block)
+	{
+		if (m_markedEnd[block] == m_blockEnd[block])
+		{
+			m_markedEnd[block] = m_blockBegin[block];
+			return;
+		}
+
+		// Marked prefix of the block becomes a new block
+		auto newBlock = m_blockBegin.size();
+		m_blockBegin.push_back(m_blockBegin[block]);
+		m_blockEnd.push_back(m_markedEnd[block]);
+		m_markedEnd.push_back(m_blockBegin[block]);
+		m_blockBegin[block] = m_markedEnd[block];
+
+		for (auto i = m_blockBegin[newBlock]; i < m_blockEnd[newBlock]; ++i)
+		{
+			m_blockOf[m_elements[i]] = newBlock;
+		}
+
+		m_isPending.resize(m_blockBegin.size() * m_inputsCount, false);
+		auto smaller = (m_blockEnd[newBlock] - m_blockBegin[newBlock] <= m_blockEnd[block] - m_blockBegin[block])
+			? newBlock
+			: block;
+		for (size_t input = 0; input < m_inputsCount; ++input)
+		{
+			AddSplitter(m_isPending[block * m_inputsCount + input] ? newBlock : smaller, input);
+		}
+	}
+
+	void AddSplitter(size_t block, size_t input)
+	{
+		auto pendingIndex = block * m_inputsCount + input;
+		if (!m_isPending[pendingIndex])
+		{
+			m_isPending[pendingIndex] = true;
+			m_pending.emplace_back(block, input);
+		}
+	}
+
+	size_t m_statesCount;
+	size_t m_inputsCount;
+	size_t m_splittersCount;
+
+	std::vector<size_t> m_predecessorsOffsets;
+	std::vector<std::uint32_t> m_predecessors;
+
+	std::vector<size_t> m_elements;
+	std::vector<size_t> m_positions;
+	std::vector<size_t> m_blockOf;
+	std::vector<size_t> m_blockBegin;
+	std::vector<size_t> m_blockEnd;
+	std::vector<size_t> m_markedEnd;
+
+	std::vector<std::pair<size_t, size_t>> m_pending;
+	std::vector<bool> m_isPending;
+
+	std::vector<size_t> m_touchedStates;
+	std::vector<size_t> m_touchedBlocks;
+};
+
+#endif // !AUTOMATA_PARTITION_REFINEMENT_HPP_
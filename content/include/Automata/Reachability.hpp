@@ -0,0 +1,63 @@
+#ifndef AUTOMATA_REACHABILITY_HPP_
+#define AUTOMATA_REACHABILITY_HPP_
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace reachability_excps
+{
+
+constexpr auto WRONG_TRANSITIONS_SIZE_MSG = "Failed to search reachable states. Transitions must contain statesCount * inputsCount targets";
+constexpr auto WRONG_START_MSG = "Failed to search reachable states. Start state is out of range";
+constexpr auto WRONG_TARGET_MSG = "Failed to search reachable states. Transition's target is out of range";
+
+}; // namespace reachability_excps
+
+using ReachedStates = std::vector<bool>;
+
+// Breadth-first search from start over an input-major transition array:
+// transitions[input * statesCount + state] is the target of state by input.
+// Every state is enqueued at most once, so the search is linear in the table size
+inline ReachedStates FindReachableStates(size_t statesCount,
+	size_t inputsCount,
+	const std::vector<std::uint32_t>& transitions,
+	size_t start)
+{
+	if (transitions.size() != statesCount * inputsCount)
+	{
+		throw std::invalid_argument(reachability_excps::WRONG_TRANSITIONS_SIZE_MSG);
+	}
+	if (start >= statesCount)
+	{
+		throw std::out_of_range(reachability_excps::WRONG_START_MSG);
+	}
+
+	ReachedStates reached(statesCount, false);
+	std::vector<size_t> queue{};
+	queue.reserve(statesCount);
+
+	reached[start] = true;
+	queue.push_back(start);
+	for (size_t head = 0; head < queue.size(); ++head)
+	{
+		auto state = queue[head];
+		for (size_t input = 0; input < inputsCount; ++input)
+		{
+			auto target = transitions[input * statesCount + state];
+			if (target >= statesCount)
+			{
+				throw std::out_of_range(reachability_excps::WRONG_TARGET_MSG);
+			}
+			if (!reached[target])
+			{
+				reached[target] = true;
+				queue.push_back(target);
+			}
+		}
+	}
+
+	return reached;
+}
+
+#endif // !AUTOMATA_REACHABILITY_HPP_
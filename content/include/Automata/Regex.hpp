@@ -0,0 +1,538 @@
+#ifndef AUTOMATA_REGEX_HPP_
+#define AUTOMATA_REGEX_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cctype>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "NfaTable.hpp"
+#include "SymbolTable.hpp"
+
+namespace regex_excps
+{
+
+constexpr auto UNEXPECTED_END_MSG = "Failed to compile regex. Unexpected end of pattern";
+constexpr auto UNEXPECTED_CHAR_MSG = "Failed to compile regex. Unexpected character at position ";
+constexpr auto UNCLOSED_GROUP_MSG = "Failed to compile regex. Group is not closed at position ";
+constexpr auto UNCLOSED_CLASS_MSG = "Failed to compile regex. Character class is not closed at position ";
+constexpr auto WRONG_RANGE_MSG = "Failed to compile regex. Wrong character range at position ";
+constexpr auto NOTHING_TO_REPEAT_MSG = "Failed to compile regex. Nothing to repeat at position ";
+constexpr auto ZERO_TAG_MSG = "Failed to compile regex. Accept tag must not be 0";
+constexpr auto NO_PATTERNS_MSG = "Failed to build NFA. No patterns were added";
+
+}; // namespace regex_excps
+
+// Compiles regular expressions over bytes into one Thompson NFA: state 0 is a common start state
+// with epsilon transitions to the start of every added pattern, the final state of a pattern
+// gets its accept tag. Supported syntax: literals, '.', escapes \n \r \t \d \w \s and of metacharacters,
+// classes [a-z_] and [^...], grouping (), alternation |, repetitions * + ?.
+// Patterns are parsed straight into fragments of the NFA, so no syntax tree is built: states, edges
+// and character sets of all patterns live in flat pools of the compiler that only grow.
+// Inputs of the NFA are classes of bytes that no pattern distinguishes, named x0, x1, ...,
+// WriteByteClasses writes which bytes every input stands for
+class RegexCompiler
+{
+public:
+	using Id = SymbolTable::Id;
+	using CharSet = std::bitset<256>;
+	using ByteClasses = std::array<Id, 256>;
+
+	RegexCompiler()
+	{
+		m_byteSets.fill(NO_SET);
+		m_acceptTags.push_back(0);
+	}
+
+	// Adds pattern whose matches are accepted with the tag. Lower tags win when patterns overlap.
+	// A wrong pattern throws and leaves the compiler as it was before the call
+	void Add(std::string_view pattern, std::uint32_t tag = 1)
+	{
+		if (tag == 0)
+		{
+			throw std::invalid_argument(regex_excps::ZERO_TAG_MSG);
+		}
+
+		const auto statesCount = m_acceptTags.size();
+		const auto edgesCount = m_edges.size();
+		const auto setsCount = m_sets.size();
+		Fragment fragment{};
+		try
+		{
+			m_pattern = pattern;
+			m_position = 0;
+			fragment = ParseAlternation();
+			if (m_position != m_pattern.size())
+			{
+				throw std::invalid_argument(regex_excps::UNEXPECTED_CHAR_MSG + std::to_string(m_position));
+			}
+		}
+		catch (...)
+		{
+			m_acceptTags.resize(statesCount);
+			m_edges.resize(edgesCount);
+			m_sets.resize(setsCount);
+			for (auto& set : m_byteSets)
+			{
+				set = set != NO_SET && set >= setsCount ? NO_SET : set;
+			}
+			throw;
+		}
+
+		AddEpsilon(START_STATE, fragment.m_start);
+		m_acceptTags[fragment.m_end] = tag;
+		++m_patternsCount;
+	}
+
+	size_t GetPatternsCount() const noexcept
+	{
+		return m_patternsCount;
+	}
+
+	// Byte class of every byte, it's the input id of the byte in the built NFA
+	const ByteClasses& GetByteClasses() const noexcept
+	{
+		return m_byteClasses;
+	}
+
+	NfaTable Build()
+	{
+		if (m_patternsCount == 0)
+		{
+			throw std::invalid_argument(regex_excps::NO_PATTERNS_MSG);
+		}
+
+		auto classesCount = BuildByteClasses();
+		std::vector<size_t> representatives(classesCount, 256);
+		for (size_t byte = 256; byte-- > 0;)
+		{
+			representatives[m_byteClasses[byte]] = byte;
+		}
+
+		const auto statesCount = m_acceptTags.size();
+		NfaTargets::Ids offsets(classesCount * statesCount + 1);
+		NfaTargets::Ids epsilonOffsets(statesCount + 1);
+
+		// Counting pass fills sizes of cells, the second one places targets
+		auto forEachCell = [&](auto&& fn) {
+			for (auto& edge : m_edges)
+			{
+				if (edge.m_set == EPSILON)
+				{
+					fn(true, edge.m_from, edge.m_to);
+					continue;
+				}
+				for (size_t byteClass = 0; byteClass < classesCount; ++byteClass)
+				{
+					if (m_sets[edge.m_set][representatives[byteClass]])
+					{
+						fn(false, byteClass * statesCount + edge.m_from, edge.m_to);
+					}
+				}
+			}
+		};
+
+		forEachCell([&](bool isEpsilon, size_t cell, Id) {
+			++(isEpsilon ? epsilonOffsets : offsets)[cell + 1];
+		});
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		std::partial_sum(epsilonOffsets.begin(), epsilonOffsets.end(), epsilonOffsets.begin());
+
+		NfaTargets::Ids targets(offsets.back());
+		NfaTargets::Ids epsilonTargets(epsilonOffsets.back());
+		auto positions = offsets;
+		auto epsilonPositions = epsilonOffsets;
+		forEachCell([&](bool isEpsilon, size_t cell, Id target) {
+			if (isEpsilon)
+			{
+				epsilonTargets[epsilonPositions[cell]++] = target;
+			}
+			else
+			{
+				targets[positions[cell]++] = target;
+			}
+		});
+
+		return NfaTable{
+			SymbolTable::MakeIndexed('q', statesCount),
+			SymbolTable::MakeIndexed('x', classesCount),
+			m_acceptTags,
+			NfaTargets{ classesCount, statesCount, std::move(offsets), std::move(targets) },
+			NfaTargets{ 1, statesCount, std::move(epsilonOffsets), std::move(epsilonTargets) }
+		};
+	}
+
+private:
+	static constexpr Id START_STATE = 0;
+	static constexpr Id EPSILON = std::numeric_limits<Id>::max();
+	static constexpr Id NO_SET = std::numeric_limits<Id>::max();
+
+	struct Fragment
+	{
+		Id m_start;
+		Id m_end;
+	};
+
+	// Transition by any byte of the set, or epsilon transition
+	struct Edge
+	{
+		Id m_from;
+		Id m_to;
+		Id m_set;
+	};
+
+	Id AddState()
+	{
+		m_acceptTags.push_back(0);
+		return static_cast<Id>(m_acceptTags.size() - 1);
+	}
+
+	void AddEpsilon(Id from, Id to)
+	{
+		m_edges.push_back(Edge{ from, to, EPSILON });
+	}
+
+	Fragment AddSet(Id set)
+	{
+		auto start = AddState();
+		auto end = AddState();
+		m_edges.push_back(Edge{ start, end, set });
+		return { start, end };
+	}
+
+	Id InternSet(const CharSet& set)
+	{
+		m_sets.push_back(set);
+		return static_cast<Id>(m_sets.size() - 1);
+	}
+
+	Id InternByte(unsigned char byte)
+	{
+		if (m_byteSets[byte] == NO_SET)
+		{
+			m_byteSets[byte] = InternSet(CharSet{}.set(byte));
+		}
+		return m_byteSets[byte];
+	}
+
+	bool IsEnd() const noexcept
+	{
+		return m_position == m_pattern.size();
+	}
+
+	char Peek() const noexcept
+	{
+		return m_pattern[m_position];
+	}
+
+	char Take()
+	{
+		if (IsEnd())
+		{
+			throw std::invalid_argument(regex_excps::UNEXPECTED_END_MSG);
+		}
+		return m_pattern[m_position++];
+	}
+
+	Fragment ParseAlternation()
+	{
+		auto fragment = ParseConcatenation();
+		if (IsEnd() || Peek() != '|')
+		{
+			return fragment;
+		}
+
+		auto start = AddState();
+		auto end = AddState();
+		AddEpsilon(start, fragment.m_start);
+		AddEpsilon(fragment.m_end, end);
+		while (!IsEnd() && Peek() == '|')
+		{
+			++m_position;
+			auto alternative = ParseConcatenation();
+			AddEpsilon(start, alternative.m_start);
+			AddEpsilon(alternative.m_end, end);
+		}
+
+		return { start, end };
+	}
+
+	Fragment ParseConcatenation()
+	{
+		Fragment result{};
+		bool isEmpty = true;
+		while (!IsEnd() && Peek() != '|' && Peek() != ')')
+		{
+			auto fragment = ParseRepetition();
+			if (isEmpty)
+			{
+				result = fragment;
+				isEmpty = false;
+				continue;
+			}
+			AddEpsilon(result.m_end, fragment.m_start);
+			result.m_end = fragment.m_end;
+		}
+
+		if (isEmpty)
+		{
+			auto state = AddState();
+			return { state, state };
+		}
+		return result;
+	}
+
+	Fragment ParseRepetition()
+	{
+		auto fragment = ParseAtom();
+		while (!IsEnd() && (Peek() == '*' || Peek() == '+' || Peek() == '?'))
+		{
+			auto op = Take();
+			auto start = AddState();
+			auto end = AddState();
+			AddEpsilon(start, fragment.m_start);
+			AddEpsilon(fragment.m_end, end);
+			if (op != '+')
+			{
+				AddEpsilon(start, end);
+			}
+			if (op != '?')
+			{
+				AddEpsilon(fragment.m_end, fragment.m_start);
+			}
+			fragment = { start, end };
+		}
+
+		return fragment;
+	}
+
+	Fragment ParseAtom()
+	{
+		auto position = m_position;
+		auto ch = Take();
+		switch (ch)
+		{
+		case '(':
+		{
+			auto fragment = ParseAlternation();
+			if (IsEnd() || Take() != ')')
+			{
+				throw std::invalid_argument(regex_excps::UNCLOSED_GROUP_MSG + std::to_string(position));
+			}
+			return fragment;
+		}
+		case '[':
+			return AddSet(InternSet(ParseClass(position)));
+		case '.':
+			return AddSet(InternSet(CharSet{}.set().reset('\n')));
+		case '\\':
+			return AddSet(ParseEscape());
+		case '*':
+		case '+':
+		case '?':
+			throw std::invalid_argument(regex_excps::NOTHING_TO_REPEAT_MSG + std::to_string(position));
+		default:
+			return AddSet(InternByte(static_cast<unsigned char>(ch)));
+		}
+	}
+
+	static CharSet GetEscapedSet(char ch)
+	{
+		CharSet result{};
+		switch (ch)
+		{
+		case 'd':
+			for (auto digit = '0'; digit <= '9'; ++digit)
+			{
+				result.set(static_cast<unsigned char>(digit));
+			}
+			return result;
+		case 'w':
+			for (size_t byte = 0; byte < 128; ++byte)
+			{
+				if (std::isalnum(static_cast<int>(byte)) || byte == '_')
+				{
+					result.set(byte);
+				}
+			}
+			return result;
+		case 's':
+			for (auto space : std::string_view{ " \t\n\r\f\v" })
+			{
+				result.set(static_cast<unsigned char>(space));
+			}
+			return result;
+		case 'n':
+			return result.set('\n');
+		case 'r':
+			return result.set('\r');
+		case 't':
+			return result.set('\t');
+		default:
+			return result.set(static_cast<unsigned char>(ch));
+		}
+	}
+
+	static unsigned char GetFirstByte(const CharSet& set) noexcept
+	{
+		size_t byte = 0;
+		while (byte < set.size() - 1 && !set[byte])
+		{
+			++byte;
+		}
+		return static_cast<unsigned char>(byte);
+	}
+
+	Id ParseEscape()
+	{
+		auto set = GetEscapedSet(Take());
+		return set.count() == 1
+			? InternByte(GetFirstByte(set))
+			: InternSet(set);
+	}
+
+	CharSet ParseClass(size_t position)
+	{
+		CharSet result{};
+		bool isNegated = !IsEnd() && Peek() == '^';
+		if (isNegated)
+		{
+			++m_position;
+		}
+
+		bool isFirst = true;
+		for (;;)
+		{
+			if (IsEnd())
+			{
+				throw std::invalid_argument(regex_excps::UNCLOSED_CLASS_MSG + std::to_string(position));
+			}
+			auto ch = Take();
+			if (ch == ']' && !isFirst)
+			{
+				break;
+			}
+			isFirst = false;
+
+			if (ch == '\\')
+			{
+				auto escaped = GetEscapedSet(Take());
+				if (escaped.count() != 1)
+				{
+					result |= escaped;
+					continue;
+				}
+				ch = static_cast<char>(GetFirstByte(escaped));
+			}
+
+			auto last = ch;
+			if (m_position + 1 < m_pattern.size() && Peek() == '-' && m_pattern[m_position + 1] != ']')
+			{
+				++m_position;
+				last = Take();
+				if (static_cast<unsigned char>(last) < static_cast<unsigned char>(ch))
+				{
+					throw std::invalid_argument(regex_excps::WRONG_RANGE_MSG + std::to_string(m_position - 1));
+				}
+			}
+			for (auto byte = static_cast<unsigned>(static_cast<unsigned char>(ch)); byte <= static_cast<unsigned char>(last); ++byte)
+			{
+				result.set(byte);
+			}
+		}
+
+		return isNegated ? ~result : result;
+	}
+
+	// Splits bytes into classes so that every used set is a union of classes
+	size_t BuildByteClasses()
+	{
+		m_byteClasses.fill(0);
+		size_t classesCount = 1;
+		std::vector<Id> remap{};
+		for (auto& set : m_sets)
+		{
+			remap.assign(classesCount * 2, NO_SET);
+			size_t newCount = 0;
+			for (size_t byte = 0; byte < 256; ++byte)
+			{
+				auto& newClass = remap[m_byteClasses[byte] * 2 + set[byte]];
+				if (newClass == NO_SET)
+				{
+					newClass = static_cast<Id>(newCount++);
+				}
+				m_byteClasses[byte] = newClass;
+			}
+			classesCount = newCount;
+		}
+
+		return classesCount;
+	}
+
+	std::string_view m_pattern{};
+	size_t m_position{};
+	size_t m_patternsCount{};
+
+	NfaTable::AcceptTags m_acceptTags{};
+	std::vector<Edge> m_edges{};
+	std::vector<CharSet> m_sets{};
+	std::array<Id, 256> m_byteSets{};
+	ByteClasses m_byteClasses{};
+};
+
+// Writes a line x<class>;<bytes> for every input of a compiled NFA. Bytes are comma-separated ranges
+// like a-z, bytes that aren't printable or are one of ;,-\ are written as \xNN
+inline void WriteByteClasses(std::ostream& output, const RegexCompiler::ByteClasses& byteClasses)
+{
+	auto writeByte = [&](size_t byte) {
+		constexpr auto digits = "0123456789ABCDEF";
+		auto ch = static_cast<char>(byte);
+		if (std::isprint(static_cast<unsigned char>(byte)) && ch != ';' && ch != ',' && ch != '-' && ch != '\\')
+		{
+			output << ch;
+		}
+		else
+		{
+			output << "\\x" << digits[byte >> 4] << digits[byte & 0xF];
+		}
+	};
+
+	const auto classesCount = size_t{ *std::max_element(byteClasses.begin(), byteClasses.end()) } + 1;
+	for (size_t byteClass = 0; byteClass < classesCount; ++byteClass)
+	{
+		output << 'x' << byteClass << ';';
+		auto isFirst = true;
+		for (size_t byte = 0; byte < byteClasses.size(); ++byte)
+		{
+			if (byteClasses[byte] != byteClass || (byte != 0 && byteClasses[byte - 1] == byteClass))
+			{
+				continue;
+			}
+			auto last = byte;
+			while (last + 1 < byteClasses.size() && byteClasses[last + 1] == byteClass)
+			{
+				++last;
+			}
+
+			output << (isFirst ? "" : ",");
+			writeByte(byte);
+			if (last != byte)
+			{
+				output << '-';
+				writeByte(last);
+			}
+			isFirst = false;
+		}
+		output << '\n';
+	}
+}
+
+#endif // !AUTOMATA_REGEX_HPP_
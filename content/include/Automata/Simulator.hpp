@@ -0,0 +1,405 @@
+#ifndef AUTOMATA_SIMULATOR_HPP_
+#define AUTOMATA_SIMULATOR_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "MealyMooreTable.hpp"
+#include "Parallel.hpp"
+
+namespace simulator_excps
+{
+
+constexpr auto WRONG_STATE_MSG = "Failed to run automaton. Start state is out of range";
+constexpr auto WRONG_INPUT_MSG = "Failed to run automaton. Input signal is out of range";
+constexpr auto TOO_BIG_TABLE_MSG = "Failed to build simulator. Table cells count exceeds id range";
+constexpr auto SHORT_OUTPUTS_MSG = "Failed to run automaton. Outputs are shorter than inputs";
+
+}; // namespace simulator_excps
+
+// Runs Mealy automaton over sequences of input ids. Cells are stored state-major as pairs of
+// target's row offset and output id, so one step is a single load of a pair and an add
+class MealySimulator
+{
+public:
+	using Id = TransitionMatrix::Id;
+
+	explicit MealySimulator(const MealyTable& table)
+		: m_inputsCount(table.GetTransitions().GetSize())
+		, m_statesCount(table.GetStates().GetSize())
+		, m_cells(m_inputsCount * m_statesCount)
+	{
+		if (m_cells.size() > std::numeric_limits<Id>::max())
+		{
+			throw std::length_error(simulator_excps::TOO_BIG_TABLE_MSG);
+		}
+
+		const auto& targets = table.GetTargets();
+		const auto& outputs = table.GetOutputs();
+		for (size_t state = 0; state < m_statesCount; ++state)
+		{
+			for (size_t input = 0; input < m_inputsCount; ++input)
+			{
+				m_cells[state * m_inputsCount + input] = Cell{
+					static_cast<Id>(targets.At(input, state) * m_inputsCount),
+					outputs.At(input, state)
+				};
+			}
+		}
+	}
+
+	// Writes output id of every step into outputs and returns the last state
+	Id Run(Id state, std::span<const Id> inputs, std::span<Id> outputs) const
+	{
+		CheckRun(state, inputs);
+		if (outputs.size() < inputs.size())
+		{
+			throw std::invalid_argument(simulator_excps::SHORT_OUTPUTS_MSG);
+		}
+		if (inputs.empty())
+		{
+			return state;
+		}
+
+		return GetState(RunRows(GetRow(state), inputs, outputs.data()));
+	}
+
+	// Returns the last state only
+	Id Run(Id state, std::span<const Id> inputs) const
+	{
+		CheckRun(state, inputs);
+		if (inputs.empty())
+		{
+			return state;
+		}
+
+		return GetState(RunRows(GetRow(state), inputs));
+	}
+
+	// Same as Run, but inputs are split into chunks run on separate threads. Every chunk but the first
+	// is run ahead from all states, whose paths are merged as they meet, or, for big tables, from the state
+	// reached by the end of the previous chunk when run from state 0. Paths from all states are given up
+	// when they don't merge within a few times the chunk's steps, as for automata that permute states.
+	// Last states of chunks are composed, chunks whose guess missed or was given up are rerun
+	// on the calling thread, and outputs are written by chunks in parallel
+	Id RunParallel(Id state, std::span<const Id> inputs, std::span<Id> outputs, size_t threadsCount) const
+	{
+		CheckRun(state, inputs);
+		if (outputs.size() < inputs.size())
+		{
+			throw std::invalid_argument(simulator_excps::SHORT_OUTPUTS_MSG);
+		}
+
+		const auto chunksCount = std::min(threadsCount, inputs.size() / MIN_CHUNK_SIZE);
+		if (chunksCount <= 1)
+		{
+			return Run(state, inputs, outputs);
+		}
+
+		auto getChunk = [&](size_t chunk) {
+			auto begin = inputs.size() * chunk / chunksCount;
+			return inputs.subspan(begin, inputs.size() * (chunk + 1) / chunksCount - begin);
+		};
+
+		// Last row of every chunk for every start state, NO_ROW where it's unknown
+		std::vector<Id> startRows(chunksCount);
+		startRows[0] = GetRow(state);
+		Id row{};
+		std::vector<std::vector<Id>> endRows(chunksCount);
+		ParallelFor(chunksCount, chunksCount, [&](size_t begin, size_t end, size_t) {
+			for (auto chunk = begin; chunk < end; ++chunk)
+			{
+				if (chunk == 0)
+				{
+					row = RunRows(startRows[0], getChunk(0));
+					continue;
+				}
+				endRows[chunk] = m_statesCount <= MAX_ENUMERATED_STATES
+					? RunFromAllStates(getChunk(chunk))
+					: RunFromGuessedState(getChunk(chunk - 1), getChunk(chunk));
+			}
+		});
+
+		for (size_t chunk = 1; chunk < chunksCount; ++chunk)
+		{
+			startRows[chunk] = row;
+			row = endRows[chunk][GetState(row)];
+			if (row == NO_ROW)
+			{
+				row = RunRows(startRows[chunk], getChunk(chunk));
+			}
+		}
+
+		ParallelFor(chunksCount, chunksCount, [&](size_t begin, size_t end, size_t) {
+			for (auto chunk = begin; chunk < end; ++chunk)
+			{
+				auto chunkInputs = getChunk(chunk);
+				RunRows(startRows[chunk], chunkInputs, outputs.data() + (chunkInputs.data() - inputs.data()));
+			}
+		});
+
+		return GetState(row);
+	}
+
+	size_t GetInputsCount() const noexcept
+	{
+		return m_inputsCount;
+	}
+
+	size_t GetStatesCount() const noexcept
+	{
+		return m_statesCount;
+	}
+
+private:
+	static constexpr Id NO_ROW = std::numeric_limits<Id>::max();
+	// Chunks shorter than this aren't worth a thread
+	static constexpr size_t MIN_CHUNK_SIZE = 1 << 16;
+	// Bigger tables are run ahead from a guessed state only
+	static constexpr size_t MAX_ENUMERATED_STATES = 1024;
+	// Paths run from all states are merged once per this count of steps
+	static constexpr size_t MERGE_PERIOD = 16;
+	// Paths run from all states are given up after this many times the chunk's steps
+	static constexpr size_t MAX_SPECULATION_FACTOR = 4;
+	// Inputs before a chunk used to guess its start state
+	static constexpr size_t GUESS_WINDOW = 4096;
+
+	struct Cell
+	{
+		Id m_row;
+		Id m_output;
+	};
+
+	Id GetRow(Id state) const noexcept
+	{
+		return static_cast<Id>(state * m_inputsCount);
+	}
+
+	Id GetState(Id row) const noexcept
+	{
+		return static_cast<Id>(row / m_inputsCount);
+	}
+
+	Id RunRows(Id row, std::span<const Id> inputs, Id* output) const noexcept
+	{
+		auto cells = m_cells.data();
+		for (auto input : inputs)
+		{
+			auto cell = cells[row + input];
+			row = cell.m_row;
+			*output++ = cell.m_output;
+		}
+		return row;
+	}
+
+	Id RunRows(Id row, std::span<const Id> inputs) const noexcept
+	{
+		auto cells = m_cells.data();
+		for (auto input : inputs)
+		{
+			row = cells[row + input].m_row;
+		}
+		return row;
+	}
+
+	// Runs inputs from every state at once. Paths that reach the same state are merged,
+	// so usually only one path is left after a few steps. Returns NO_ROW for all states
+	// if the paths cost more than MAX_SPECULATION_FACTOR runs of the inputs
+	std::vector<Id> RunFromAllStates(std::span<const Id> inputs) const
+	{
+		const auto maxStepsCount = MAX_SPECULATION_FACTOR * inputs.size();
+		std::vector<Id> rows(m_statesCount);
+		std::vector<Id> pathOfState(m_statesCount);
+		for (Id state = 0; state < m_statesCount; ++state)
+		{
+			rows[state] = GetRow(state);
+			pathOfState[state] = state;
+		}
+
+		std::vector<Id> pathOfRow(m_statesCount, NO_ROW);
+		std::vector<Id> newPath(m_statesCount);
+		size_t position = 0;
+		size_t stepsCount = 0;
+		while (rows.size() > 1 && position < inputs.size())
+		{
+			auto end = std::min(position + MERGE_PERIOD, inputs.size());
+			stepsCount += rows.size() * (end - position);
+			if (stepsCount > maxStepsCount)
+			{
+				return std::vector<Id>(m_statesCount, NO_ROW);
+			}
+			for (auto& row : rows)
+			{
+				row = RunRows(row, inputs.subspan(position, end - position));
+			}
+			position = end;
+
+			std::vector<Id> mergedRows{};
+			for (size_t path = 0; path < rows.size(); ++path)
+			{
+				auto& merged = pathOfRow[GetState(rows[path])];
+				if (merged == NO_ROW)
+				{
+					merged = static_cast<Id>(mergedRows.size());
+					mergedRows.push_back(rows[path]);
+				}
+				newPath[path] = merged;
+			}
+			for (auto row : mergedRows)
+			{
+				pathOfRow[GetState(row)] = NO_ROW;
+			}
+			for (auto& path : pathOfState)
+			{
+				path = newPath[path];
+			}
+			rows = std::move(mergedRows);
+		}
+		if (rows.size() == 1)
+		{
+			rows[0] = RunRows(rows[0], inputs.subspan(position));
+		}
+
+		std::vector<Id> result(m_statesCount);
+		for (Id state = 0; state < m_statesCount; ++state)
+		{
+			result[state] = rows[pathOfState[state]];
+		}
+		return result;
+	}
+
+	// Runs inputs from the state reached by the tail of previous inputs, the guess is right
+	// whenever the automaton forgets its state within the tail
+	std::vector<Id> RunFromGuessedState(std::span<const Id> previousInputs, std::span<const Id> inputs) const
+	{
+		auto window = std::min(GUESS_WINDOW, previousInputs.size());
+		auto guessedRow = RunRows(GetRow(0), previousInputs.subspan(previousInputs.size() - window));
+
+		std::vector<Id> result(m_statesCount, NO_ROW);
+		result[GetState(guessedRow)] = RunRows(guessedRow, inputs);
+		return result;
+	}
+
+	void CheckRun(Id state, std::span<const Id> inputs) const
+	{
+		if (state >= m_statesCount)
+		{
+			throw std::out_of_range(simulator_excps::WRONG_STATE_MSG);
+		}
+		if (!inputs.empty() && *std::max_element(inputs.begin(), inputs.end()) >= m_inputsCount)
+		{
+			throw std::out_of_range(simulator_excps::WRONG_INPUT_MSG);
+		}
+	}
+
+	size_t m_inputsCount;
+	size_t m_statesCount;
+	std::vector<Cell> m_cells;
+};
+
+// Runs Moore automaton over sequences of input ids. Every state is a row of targets' row offsets
+// followed by the state's output id, so one step is a single load
+class MooreSimulator
+{
+public:
+	using Id = TransitionMatrix::Id;
+
+	explicit MooreSimulator(const MooreTable& table)
+		: m_inputsCount(table.GetTransitions().GetSize())
+		, m_statesCount(table.GetStates().GetSize())
+		, m_rowSize(m_inputsCount + 1)
+		, m_rows(m_rowSize * m_statesCount)
+	{
+		if (m_rows.size() > std::numeric_limits<Id>::max())
+		{
+			throw std::length_error(simulator_excps::TOO_BIG_TABLE_MSG);
+		}
+
+		const auto& targets = table.GetTargets();
+		for (size_t state = 0; state < m_statesCount; ++state)
+		{
+			auto row = m_rows.data() + state * m_rowSize;
+			for (size_t input = 0; input < m_inputsCount; ++input)
+			{
+				row[input] = static_cast<Id>(targets.At(input, state) * m_rowSize);
+			}
+			row[m_inputsCount] = table.GetStateSignals()[state];
+		}
+	}
+
+	// Writes output id of the state entered by every step into outputs and returns the last state
+	Id Run(Id state, std::span<const Id> inputs, std::span<Id> outputs) const
+	{
+		CheckRun(state, inputs);
+		if (outputs.size() < inputs.size())
+		{
+			throw std::invalid_argument(simulator_excps::SHORT_OUTPUTS_MSG);
+		}
+
+		auto rows = m_rows.data();
+		auto row = static_cast<Id>(state * m_rowSize);
+		auto output = outputs.data();
+		for (auto input : inputs)
+		{
+			row = rows[row + input];
+			*output++ = rows[row + m_inputsCount];
+		}
+
+		return static_cast<Id>(row / m_rowSize);
+	}
+
+	// Returns the last state only
+	Id Run(Id state, std::span<const Id> inputs) const
+	{
+		CheckRun(state, inputs);
+
+		auto rows = m_rows.data();
+		auto row = static_cast<Id>(state * m_rowSize);
+		for (auto input : inputs)
+		{
+			row = rows[row + input];
+		}
+
+		return static_cast<Id>(row / m_rowSize);
+	}
+
+	// Output id of the state
+	Id GetOutput(Id state) const noexcept
+	{
+		return m_rows[state * m_rowSize + m_inputsCount];
+	}
+
+	size_t GetInputsCount() const noexcept
+	{
+		return m_inputsCount;
+	}
+
+	size_t GetStatesCount() const noexcept
+	{
+		return m_statesCount;
+	}
+
+private:
+	void CheckRun(Id state, std::span<const Id> inputs) const
+	{
+		if (state >= m_statesCount)
+		{
+			throw std::out_of_range(simulator_excps::WRONG_STATE_MSG);
+		}
+		if (!inputs.empty() && *std::max_element(inputs.begin(), inputs.end()) >= m_inputsCount)
+		{
+			throw std::out_of_range(simulator_excps::WRONG_INPUT_MSG);
+		}
+	}
+
+	size_t m_inputsCount;
+	size_t m_statesCount;
+	size_t m_rowSize;
+	std::vector<Id> m_rows;
+};
+
+#endif // !AUTOMATA_SIMULATOR_HPP_
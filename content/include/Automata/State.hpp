@@ -1,10 +1,15 @@
 #ifndef AUTOMATA_STATE_HPP_
 #define AUTOMATA_STATE_HPP_
 
+#include <charconv>
 #include <cstring>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
 #include <utility>
 
 namespace state_excps
@@ -12,46 +17,157 @@ namespace state_excps
 
 constexpr auto FAILED_CONSTRUCT_SIGNAL_IS_ALPHA_MSG = "Failed to construct Signal. _1[0] must be alpha";
 constexpr auto FAILED_CONSTRUCT_SIGNAL_IS_DIGIT_MSG = "Failed to construct Signal. All after _1[0] must be digits";
+constexpr auto FAILED_CONSTRUCT_SIGNAL_INDEX_RANGE_MSG = "Failed to construct Signal. Index after _1[0] is too big";
 
 constexpr auto FAILED_CONSTRUCT_SIGNAL_MSG = "Failed to construct Signal. _1 must contain at least 2 characters";
 constexpr auto FAILED_LESS_COMPARE_SIGNAL_MSG = "Can't less-compare signals with different labels";
 
 constexpr auto FAILED_CONSTRUCT_MEALY_MSG = "Failed to construct Mealy's State. _1 must contain at least 5 characters";
+constexpr auto FAILED_CONSTRUCT_MEALY_DELIMETER_MSG = "Failed to construct Mealy's State. _1 must contain '/' between state and signal";
 
 }; // namespace state_excps
 
-template <typename T>
-inline void TryParseCharContainer(T&& src)
+enum class StateParseError
 {
-	if (!std::isalpha(src[0]))
+	NONE = 0,
+	SIGNAL_TOO_SHORT,
+	SIGNAL_LABEL_IS_NOT_ALPHA,
+	SIGNAL_INDEX_IS_NOT_DIGITS,
+	SIGNAL_INDEX_OUT_OF_RANGE,
+	MEALY_TOO_SHORT,
+	MEALY_NO_DELIMETER,
+};
+
+constexpr const char* GetStateParseErrorMessage(StateParseError error) noexcept
+{
+	switch (error)
 	{
-		throw std::invalid_argument(state_excps::FAILED_CONSTRUCT_SIGNAL_IS_ALPHA_MSG);
+	case StateParseError::SIGNAL_TOO_SHORT:
+		return state_excps::FAILED_CONSTRUCT_SIGNAL_MSG;
+	case StateParseError::SIGNAL_LABEL_IS_NOT_ALPHA:
+		return state_excps::FAILED_CONSTRUCT_SIGNAL_IS_ALPHA_MSG;
+	case StateParseError::SIGNAL_INDEX_IS_NOT_DIGITS:
+		return state_excps::FAILED_CONSTRUCT_SIGNAL_IS_DIGIT_MSG;
+	case StateParseError::SIGNAL_INDEX_OUT_OF_RANGE:
+		return state_excps::FAILED_CONSTRUCT_SIGNAL_INDEX_RANGE_MSG;
+	case StateParseError::MEALY_TOO_SHORT:
+		return state_excps::FAILED_CONSTRUCT_MEALY_MSG;
+	case StateParseError::MEALY_NO_DELIMETER:
+		return state_excps::FAILED_CONSTRUCT_MEALY_DELIMETER_MSG;
+	default:
+		return "";
 	}
+}
+
+constexpr void ThrowIfFailed(StateParseError error)
+{
+	if (error != StateParseError::NONE)
+	{
+		throw std::invalid_argument(GetStateParseErrorMessage(error));
+	}
+}
 
-	if constexpr (std::is_same_v<T, char*>)
+constexpr bool IsSignalLabel(char ch) noexcept
+{
+	return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+}
+
+// std::from_chars isn't usable in constant expressions, so tables parsed at compile time use this one
+constexpr StateParseError TryParseIndex(std::string_view digits, unsigned int& index) noexcept
+{
+	unsigned int result = 0;
+	for (auto ch : digits)
 	{
-		if (std::strlen(src) < 2)
+		if (ch < '0' || ch > '9')
 		{
-			throw std::invalid_argument(state_excps::FAILED_CONSTRUCT_SIGNAL_MSG);
+			return StateParseError::SIGNAL_INDEX_IS_NOT_DIGITS;
 		}
+		auto digit = static_cast<unsigned int>(ch - '0');
+		if (result > (std::numeric_limits<unsigned int>::max() - digit) / 10)
+		{
+			return StateParseError::SIGNAL_INDEX_OUT_OF_RANGE;
+		}
+		result = result * 10 + digit;
+	}
+	index = result;
+
+	return StateParseError::NONE;
+}
 
-		if (!std::all_of(src + 1, src + std::strlen(src) - 1, std::isdigit))
+// Parses label and index of a name like "q12" without allocations and exceptions
+constexpr StateParseError TryParseSignalParts(std::string_view src, unsigned char& label, unsigned int& index) noexcept
+{
+	if (src.size() < 2)
+	{
+		return StateParseError::SIGNAL_TOO_SHORT;
+	}
+	if (!IsSignalLabel(src[0]))
+	{
+		return StateParseError::SIGNAL_LABEL_IS_NOT_ALPHA;
+	}
+	// Index is parsed into a local, so outputs stay unchanged on failure
+	unsigned int result{};
+	if (std::is_constant_evaluated())
+	{
+		if (auto error = TryParseIndex(src.substr(1), result); error != StateParseError::NONE)
 		{
-			throw std::invalid_argument(state_excps::FAILED_CONSTRUCT_SIGNAL_IS_DIGIT_MSG);
+			return error;
 		}
 	}
-	if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+	else
 	{
-		if (src.size() < 2)
+		auto [end, ec] = std::from_chars(src.data() + 1, src.data() + src.size(), result);
+		if (ec == std::errc::result_out_of_range)
 		{
-			throw std::invalid_argument(state_excps::FAILED_CONSTRUCT_SIGNAL_MSG);
+			return StateParseError::SIGNAL_INDEX_OUT_OF_RANGE;
 		}
-
-		if (!std::all_of(src.begin() + 1, src.end(), std::isdigit))
+		if (ec != std::errc{} || end != src.data() + src.size())
 		{
-			throw std::invalid_argument(state_excps::FAILED_CONSTRUCT_SIGNAL_IS_DIGIT_MSG);
+			return StateParseError::SIGNAL_INDEX_IS_NOT_DIGITS;
 		}
 	}
+	label = static_cast<unsigned char>(src[0]);
+	index = result;
+
+	return StateParseError::NONE;
+}
+
+constexpr StateParseError CheckSignalName(std::string_view src) noexcept
+{
+	unsigned char label{};
+	unsigned int index{};
+	return TryParseSignalParts(src, label, index);
+}
+
+// Splits a Mealy's cell like "q12/w3" into state and signal names and checks both of them
+constexpr StateParseError TrySplitMealyState(std::string_view src, std::string_view& stateName, std::string_view& signalName) noexcept
+{
+	if (src.size() < 5)
+	{
+		return StateParseError::MEALY_TOO_SHORT;
+	}
+
+	auto delimeterPos = src.find('/');
+	if (delimeterPos == src.npos)
+	{
+		return StateParseError::MEALY_NO_DELIMETER;
+	}
+
+	// Names are checked as locals, so outputs stay unchanged on failure
+	auto state = src.substr(0, delimeterPos);
+	auto signal = src.substr(delimeterPos + 1);
+	if (auto error = CheckSignalName(state); error != StateParseError::NONE)
+	{
+		return error;
+	}
+	if (auto error = CheckSignalName(signal); error != StateParseError::NONE)
+	{
+		return error;
+	}
+	stateName = state;
+	signalName = signal;
+
+	return StateParseError::NONE;
 }
 
 struct Signal
@@ -59,58 +175,45 @@ struct Signal
 	unsigned int m_index{};
 	unsigned char m_label{};
 
-	Signal() = default;
+	constexpr Signal() = default;
 
-	explicit Signal(unsigned char label, unsigned int index)
+	constexpr explicit Signal(unsigned char label, unsigned int index)
 		: m_index(index)
 		, m_label(label)
 	{
 	}
 
-	Signal(const Signal& other)
+	constexpr Signal(const Signal& other)
 		: m_index(other.m_index)
 		, m_label(other.m_label)
 	{
 	}
 
-	Signal(Signal&& other) noexcept
+	constexpr Signal(Signal&& other) noexcept
 		: m_index()
 		, m_label()
 	{
 		*this = std::move(other);
 	}
 
-	explicit Signal(const char* const src)
-		: m_index()
-		, m_label()
+	constexpr explicit Signal(const char* const src)
+		: Signal(std::string_view{ src })
 	{
-		TryParseCharContainer(src);
-
-		m_index = static_cast<unsigned int>(std::stoi(std::string(src + 1, std::strlen(src) - 1)));
-		m_label = static_cast<unsigned char>(src[0]);
 	}
 
 	explicit Signal(const std::string& src)
-		: m_index()
-		, m_label()
+		: Signal(std::string_view{ src })
 	{
-		TryParseCharContainer(src);
-
-		m_index = static_cast<unsigned int>(std::stoi(src.c_str() + 1));
-		m_label = static_cast<unsigned char>(src[0]);
 	}
 
-	explicit Signal(const std::string_view& src)
+	constexpr explicit Signal(const std::string_view& src)
 		: m_index()
 		, m_label()
 	{
-		TryParseCharContainer(src);
-
-		m_index = static_cast<unsigned int>(std::stoi(std::string(src.data() + 1)));
-		m_label = static_cast<unsigned char>(src[0]);
+		ThrowIfFailed(TryParseSignalParts(src, m_label, m_index));
 	}
 
-	Signal& operator=(const Signal& other)
+	constexpr Signal& operator=(const Signal& other)
 	{
 		if (std::addressof(*this) != &other)
 		{
@@ -121,7 +224,7 @@ struct Signal
 		return *this;
 	}
 
-	Signal& operator=(Signal&& other) noexcept
+	constexpr Signal& operator=(Signal&& other) noexcept
 	{
 		if (std::addressof(*this) != &other)
 		{
@@ -135,13 +238,13 @@ struct Signal
 	}
 
 	template <typename T>
-	bool operator==(T&& other) const noexcept
+	constexpr bool operator==(T&& other) const noexcept
 	{
 		return (m_index == other.m_index) && (m_label == other.m_label);
 	}
 
 	template <typename T>
-	bool operator<(T&& other) const noexcept
+	constexpr bool operator<(T&& other) const noexcept
 	{
 		if (m_label == other.m_label)
 		{
@@ -170,27 +273,27 @@ struct MooreState
 {
 	State m_state{};
 
-	MooreState() = default;
+	constexpr MooreState() = default;
 
-	MooreState(const State& state)
+	constexpr MooreState(const State& state)
 		: m_state(state)
 	{
 	}
 
 	template <typename ST>
-	explicit MooreState(ST&& src)
+	constexpr explicit MooreState(ST&& src)
 		: m_state(src)
 	{
 	}
 
 	template <typename T>
-	bool operator==(T&& other) const noexcept
+	constexpr bool operator==(T&& other) const noexcept
 	{
 		return m_state == other.m_state;
 	}
 
 	template <typename T>
-	bool operator<(T&& other) const
+	constexpr bool operator<(T&& other) const
 	{
 		return m_state < other.m_state;
 	}
@@ -214,54 +317,45 @@ struct MealyState
 	State m_state{};
 	Signal m_signal{};
 
-	MealyState() = default;
+	constexpr MealyState() = default;
 
 	template <
 		typename ST,
-		typename = std::enable_if_t<!std::is_same_v<std::remove_reference_t<ST>, MealyState>>
+		typename = std::enable_if_t<!std::is_same_v<std::remove_cvref_t<ST>, MealyState>>
 	>
-	explicit MealyState(ST&& src)
+	constexpr explicit MealyState(ST&& src)
 		: m_state()
 		, m_signal()
 	{
-		if (std::ssize(src) < 5)
-		{
-			throw std::invalid_argument(state_excps::FAILED_CONSTRUCT_MEALY_MSG);
-		}
+		std::string_view stateName{};
+		std::string_view signalName{};
+		ThrowIfFailed(TrySplitMealyState(std::string_view{ src }, stateName, signalName));
 
-		m_state = std::move(State(src));
-
-		if constexpr (std::is_same_v<char*, ST>)
-		{
-			m_signal = std::move(Signal(src + 3));
-		}
-		else
-		{
-			m_signal = std::move(Signal(src.substr(3, src.size() - 3)));
-		}
+		m_state = State{ stateName };
+		m_signal = Signal{ signalName };
 	}
 
 	template <typename ST1, typename ST2>
-	explicit MealyState(ST1&& state, ST2&& signal)
+	constexpr explicit MealyState(ST1&& state, ST2&& signal)
 		: m_state(state)
 		, m_signal(signal)
 	{
 	}
 
 	template <typename T>
-	bool operator==(T&& other) const noexcept
+	constexpr bool operator==(T&& other) const noexcept
 	{
 		return (m_state == other.m_state) && (m_signal == other.m_signal);
 	}
 
 	template <typename T>
-	bool operator!=(T&& other) const noexcept
+	constexpr bool operator!=(T&& other) const noexcept
 	{
 		return !(*this == other);
 	}
 
 	template <typename T>
-	bool operator<(T&& other) const noexcept
+	constexpr bool operator<(T&& other) const noexcept
 	{
 		if (m_state < other.m_state)
 		{
@@ -288,4 +382,34 @@ struct MealyState
 	}
 };
 
+constexpr StateParseError TryParseSignal(std::string_view src, Signal& signal) noexcept
+{
+	return TryParseSignalParts(src, signal.m_label, signal.m_index);
+}
+
+constexpr StateParseError TryParseMealyState(std::string_view src, MealyState& mealyState) noexcept
+{
+	std::string_view stateName{};
+	std::string_view signalName{};
+	if (auto error = TrySplitMealyState(src, stateName, signalName); error != StateParseError::NONE)
+	{
+		return error;
+	}
+
+	Signal state{};
+	Signal signal{};
+	if (auto error = TryParseSignal(stateName, state); error != StateParseError::NONE)
+	{
+		return error;
+	}
+	if (auto error = TryParseSignal(signalName, signal); error != StateParseError::NONE)
+	{
+		return error;
+	}
+	mealyState.m_state = state;
+	mealyState.m_signal = signal;
+
+	return StateParseError::NONE;
+}
+
 #endif // !AUTOMATA_STATE_HPP_
@@ -0,0 +1,400 @@
+#ifndef AUTOMATA_STATIC_TABLE_HPP_
+#define AUTOMATA_STATIC_TABLE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "State.hpp"
+#include "TableFields.hpp"
+
+namespace static_table_excps
+{
+
+constexpr auto EMPTY_TABLE_MSG = "Failed to read static table. Table must have states and transitions";
+constexpr auto DUPLICATE_NAME_MSG = "Failed to read static table. States and transitions must be unique";
+constexpr auto WRONG_ROW_SIZE_MSG = "Failed to read static table. Row size doesn't match states count";
+constexpr auto WRONG_SIGNALS_COUNT_MSG = "Failed to read static table. Signals count doesn't match states count";
+constexpr auto UNKNOWN_TARGET_MSG = "Failed to read static table. Table doesn't contain transition's target state";
+constexpr auto UNKNOWN_NAME_MSG = "Static table doesn't contain ";
+
+}; // namespace static_table_excps
+
+// String literal usable as a template argument: StaticMealyTable<";q0;q1\nz0;q1/w0;q0/w1\n">
+template <size_t N>
+struct FixedString
+{
+	char m_data[N]{};
+
+	constexpr FixedString(const char (&src)[N])
+	{
+		std::copy_n(src, N, m_data);
+	}
+
+	constexpr std::string_view GetView() const noexcept
+	{
+		return { m_data, N - 1 };
+	}
+};
+
+struct StaticTableSize
+{
+	size_t m_statesCount;
+	size_t m_inputsCount;
+};
+
+// States are columns of the last header line, inputs are the lines after it
+constexpr StaticTableSize GetStaticTableSize(std::string_view content, size_t headerLinesCount)
+{
+	TableScanner scanner{ content };
+	std::string_view line{};
+	for (size_t i = 0; i < headerLinesCount; ++i)
+	{
+		if (!scanner.ReadLine(line))
+		{
+			throw std::invalid_argument(static_table_excps::EMPTY_TABLE_MSG);
+		}
+	}
+
+	StaticTableSize result{ 0, 0 };
+	std::string_view field{};
+	for (FieldsRange fields{ line }; fields.Next(field);)
+	{
+		result.m_statesCount += field.empty() ? 0 : 1;
+	}
+	while (scanner.ReadLine(line))
+	{
+		++result.m_inputsCount;
+	}
+
+	if (result.m_statesCount == 0 || result.m_inputsCount == 0)
+	{
+		throw std::invalid_argument(static_table_excps::EMPTY_TABLE_MSG);
+	}
+
+	return result;
+}
+
+// Index of the name among the first count names, count if there is no such name
+template <size_t N>
+constexpr size_t FindStaticName(const std::array<std::string_view, N>& names, size_t count, std::string_view name) noexcept
+{
+	return static_cast<size_t>(std::find(names.begin(), names.begin() + count, name) - names.begin());
+}
+
+template <size_t N>
+constexpr void AddUniqueStaticName(std::array<std::string_view, N>& names, size_t& count, std::string_view name)
+{
+	ThrowIfFailed(CheckSignalName(name));
+	if (FindStaticName(names, count, name) != count)
+	{
+		throw std::invalid_argument(static_table_excps::DUPLICATE_NAME_MSG);
+	}
+	names[count++] = name;
+}
+
+template <size_t N>
+constexpr std::uint32_t InternStaticName(std::array<std::string_view, N>& names, size_t& count, std::string_view name)
+{
+	auto id = FindStaticName(names, count, name);
+	if (id == count)
+	{
+		names[count++] = name;
+	}
+	return static_cast<std::uint32_t>(id);
+}
+
+template <size_t N>
+constexpr std::uint32_t FindStaticTarget(const std::array<std::string_view, N>& states, std::string_view name)
+{
+	auto id = FindStaticName(states, N, name);
+	if (id == N)
+	{
+		throw std::out_of_range(static_table_excps::UNKNOWN_TARGET_MSG);
+	}
+	return static_cast<std::uint32_t>(id);
+}
+
+template <size_t N>
+constexpr std::uint32_t GetStaticNameId(const std::array<std::string_view, N>& names, size_t count, std::string_view name)
+{
+	auto id = FindStaticName(names, count, name);
+	if (id == count)
+	{
+		throw std::out_of_range(static_table_excps::UNKNOWN_NAME_MSG + std::string(name));
+	}
+	return static_cast<std::uint32_t>(id);
+}
+
+// Reads the first field of a row as a unique input name and returns the rest of the row
+template <size_t N>
+constexpr FieldsRange ReadStaticRowInput(std::string_view line, std::array<std::string_view, N>& inputs, size_t& inputsCount)
+{
+	FieldsRange fields{ line };
+	std::string_view input{};
+	fields.Next(input);
+	AddUniqueStaticName(inputs, inputsCount, input);
+	return fields;
+}
+
+template <size_t StatesCount, size_t InputsCount>
+struct StaticMealyData
+{
+	std::array<std::string_view, StatesCount> m_states{};
+	std::array<std::string_view, InputsCount> m_inputs{};
+	std::array<std::string_view, StatesCount * InputsCount> m_signals{};
+	size_t m_signalsCount{};
+	std::array<std::uint32_t, StatesCount * InputsCount> m_targets{};
+	std::array<std::uint32_t, StatesCount * InputsCount> m_outputs{};
+};
+
+// Same format as MealyTableReader: header of states, then a row of "state/signal" cells for every input
+template <size_t StatesCount, size_t InputsCount>
+constexpr StaticMealyData<StatesCount, InputsCount> ParseStaticMealy(std::string_view content)
+{
+	StaticMealyData<StatesCount, InputsCount> result{};
+	TableScanner scanner{ content };
+
+	std::string_view line{};
+	scanner.ReadLine(line);
+	size_t statesCount = 0;
+	std::string_view field{};
+	for (FieldsRange fields{ line }; fields.Next(field);)
+	{
+		if (!field.empty())
+		{
+			AddUniqueStaticName(result.m_states, statesCount, field);
+		}
+	}
+
+	size_t inputsCount = 0;
+	while (scanner.ReadLine(line))
+	{
+		auto fields = ReadStaticRowInput(line, result.m_inputs, inputsCount);
+		auto input = inputsCount - 1;
+
+		size_t state = 0;
+		for (; fields.Next(field); ++state)
+		{
+			std::string_view stateName{};
+			std::string_view signalName{};
+			ThrowIfFailed(TrySplitMealyState(field, stateName, signalName));
+			if (state == StatesCount)
+			{
+				throw std::invalid_argument(static_table_excps::WRONG_ROW_SIZE_MSG);
+			}
+
+			auto cell = state * InputsCount + input;
+			result.m_targets[cell] = FindStaticTarget(result.m_states, stateName);
+			result.m_outputs[cell] = InternStaticName(result.m_signals, result.m_signalsCount, signalName);
+		}
+		if (state != StatesCount)
+		{
+			throw std::invalid_argument(static_table_excps::WRONG_ROW_SIZE_MSG);
+		}
+	}
+
+	return result;
+}
+
+// Mealy automaton parsed from a ';'-separated table at compile time. Cells are state-major with
+// the inputs count known to the compiler, so Step with constant arguments folds to a constant and
+// with runtime ones is a single load from a read-only array:
+//   using Table = StaticMealyTable<";q0;q1\nz0;q1/w0;q0/w1\n">;
+//   static_assert(Table::Step(Table::GetStateId("q0"), Table::GetInputId("z0")) == 1);
+// Errors in the table are compile errors
+template <FixedString Content>
+class StaticMealyTable
+{
+public:
+	using Id = std::uint32_t;
+
+	static constexpr size_t STATES_COUNT = GetStaticTableSize(Content.GetView(), 1).m_statesCount;
+	static constexpr size_t INPUTS_COUNT = GetStaticTableSize(Content.GetView(), 1).m_inputsCount;
+
+	static constexpr Id Step(Id state, Id input) noexcept
+	{
+		return DATA.m_targets[state * INPUTS_COUNT + input];
+	}
+
+	static constexpr Id GetOutput(Id state, Id input) noexcept
+	{
+		return DATA.m_outputs[state * INPUTS_COUNT + input];
+	}
+
+	static constexpr size_t GetSignalsCount() noexcept
+	{
+		return DATA.m_signalsCount;
+	}
+
+	static constexpr Id GetStateId(std::string_view name)
+	{
+		return GetStaticNameId(DATA.m_states, STATES_COUNT, name);
+	}
+
+	static constexpr Id GetInputId(std::string_view name)
+	{
+		return GetStaticNameId(DATA.m_inputs, INPUTS_COUNT, name);
+	}
+
+	static constexpr Id GetSignalId(std::string_view name)
+	{
+		return GetStaticNameId(DATA.m_signals, DATA.m_signalsCount, name);
+	}
+
+	static constexpr std::string_view GetStateName(Id state) noexcept
+	{
+		return DATA.m_states[state];
+	}
+
+	static constexpr std::string_view GetInputName(Id input) noexcept
+	{
+		return DATA.m_inputs[input];
+	}
+
+	static constexpr std::string_view GetSignalName(Id signal) noexcept
+	{
+		return DATA.m_signals[signal];
+	}
+
+private:
+	static constexpr auto DATA = ParseStaticMealy<STATES_COUNT, INPUTS_COUNT>(Content.GetView());
+};
+
+template <size_t StatesCount, size_t InputsCount>
+struct StaticMooreData
+{
+	std::array<std::string_view, StatesCount> m_states{};
+	std::array<std::string_view, InputsCount> m_inputs{};
+	std::array<std::string_view, StatesCount> m_signals{};
+	size_t m_signalsCount{};
+	std::array<std::uint32_t, StatesCount> m_stateSignals{};
+	std::array<std::uint32_t, StatesCount * InputsCount> m_targets{};
+};
+
+// Same format as MooreTableReader: header of signals, header of states, then a row of targets for every input
+template <size_t StatesCount, size_t InputsCount>
+constexpr StaticMooreData<StatesCount, InputsCount> ParseStaticMoore(std::string_view content)
+{
+	StaticMooreData<StatesCount, InputsCount> result{};
+	TableScanner scanner{ content };
+
+	std::string_view line{};
+	scanner.ReadLine(line);
+	size_t signalsCount = 0;
+	std::string_view field{};
+	for (FieldsRange fields{ line }; fields.Next(field);)
+	{
+		if (field.empty())
+		{
+			continue;
+		}
+		ThrowIfFailed(CheckSignalName(field));
+		if (signalsCount == StatesCount)
+		{
+			throw std::invalid_argument(static_table_excps::WRONG_SIGNALS_COUNT_MSG);
+		}
+		result.m_stateSignals[signalsCount++] = InternStaticName(result.m_signals, result.m_signalsCount, field);
+	}
+	if (signalsCount != StatesCount)
+	{
+		throw std::invalid_argument(static_table_excps::WRONG_SIGNALS_COUNT_MSG);
+	}
+
+	scanner.ReadLine(line);
+	size_t statesCount = 0;
+	for (FieldsRange fields{ line }; fields.Next(field);)
+	{
+		if (!field.empty())
+		{
+			AddUniqueStaticName(result.m_states, statesCount, field);
+		}
+	}
+
+	size_t inputsCount = 0;
+	while (scanner.ReadLine(line))
+	{
+		auto fields = ReadStaticRowInput(line, result.m_inputs, inputsCount);
+		auto input = inputsCount - 1;
+
+		size_t state = 0;
+		for (; fields.Next(field); ++state)
+		{
+			if (state == StatesCount)
+			{
+				throw std::invalid_argument(static_table_excps::WRONG_ROW_SIZE_MSG);
+			}
+			result.m_targets[state * InputsCount + input] = FindStaticTarget(result.m_states, field);
+		}
+		if (state != StatesCount)
+		{
+			throw std::invalid_argument(static_table_excps::WRONG_ROW_SIZE_MSG);
+		}
+	}
+
+	return result;
+}
+
+// Moore automaton parsed from a ';'-separated table at compile time, laid out like StaticMealyTable
+template <FixedString Content>
+class StaticMooreTable
+{
+public:
+	using Id = std::uint32_t;
+
+	static constexpr size_t STATES_COUNT = GetStaticTableSize(Content.GetView(), 2).m_statesCount;
+	static constexpr size_t INPUTS_COUNT = GetStaticTableSize(Content.GetView(), 2).m_inputsCount;
+
+	static constexpr Id Step(Id state, Id input) noexcept
+	{
+		return DATA.m_targets[state * INPUTS_COUNT + input];
+	}
+
+	static constexpr Id GetOutput(Id state) noexcept
+	{
+		return DATA.m_stateSignals[state];
+	}
+
+	static constexpr size_t GetSignalsCount() noexcept
+	{
+		return DATA.m_signalsCount;
+	}
+
+	static constexpr Id GetStateId(std::string_view name)
+	{
+		return GetStaticNameId(DATA.m_states, STATES_COUNT, name);
+	}
+
+	static constexpr Id GetInputId(std::string_view name)
+	{
+		return GetStaticNameId(DATA.m_inputs, INPUTS_COUNT, name);
+	}
+
+	static constexpr Id GetSignalId(std::string_view name)
+	{
+		return GetStaticNameId(DATA.m_signals, DATA.m_signalsCount, name);
+	}
+
+	static constexpr std::string_view GetStateName(Id state) noexcept
+	{
+		return DATA.m_states[state];
+	}
+
+	static constexpr std::string_view GetInputName(Id input) noexcept
+	{
+		return DATA.m_inputs[input];
+	}
+
+	static constexpr std::string_view GetSignalName(Id signal) noexcept
+	{
+		return DATA.m_signals[signal];
+	}
+
+private:
+	static constexpr auto DATA = ParseStaticMoore<STATES_COUNT, INPUTS_COUNT>(Content.GetView());
+};
+
+#endif // !AUTOMATA_STATIC_TABLE_HPP_
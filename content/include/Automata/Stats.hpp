@@ -0,0 +1,221 @@
+#ifndef AUTOMATA_STATS_HPP_
+#define AUTOMATA_STATS_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "StatsCounters.hpp"
+
+// User and system CPU time of the whole process, all threads included. Defined with the platform code in src/Stats
+double GetProcessCpuSeconds() noexcept;
+
+// Peak resident set size of the process since its start, its high-water mark
+std::uint64_t GetPeakRssBytes() noexcept;
+
+// Wall and CPU time, peak RSS and counters of the phases of one job, written as JSON:
+//   auto table = stats.MeasurePhase("read", [&] { return ReadMealyTable(content); });
+class JobStats
+{
+public:
+	struct Phase
+	{
+		std::string m_name;
+		double m_wallSeconds;
+		double m_cpuSeconds;
+		// High-water mark of the process at the end of the phase, so it includes earlier phases and other jobs
+		std::uint64_t m_processPeakRssBytes;
+		// How much the phase raised the high-water mark. A phase below the mark of earlier ones has 0
+		std::uint64_t m_peakRssGrowthBytes;
+		std::array<std::uint64_t, static_cast<size_t>(StatsCounter::COUNT)> m_counters;
+	};
+
+	using Phases = std::vector<Phase>;
+	using Counters = std::vector<std::pair<std::string, std::uint64_t>>;
+
+	// Runs fn and records it as a phase, even if it throws
+	template <typename Fn>
+	decltype(auto) MeasurePhase(std::string_view name, Fn&& fn)
+	{
+		PhaseScope scope{ *this, name };
+		return fn();
+	}
+
+	void SetCounter(std::string_view name, std::uint64_t value)
+	{
+		for (auto& [counterName, counterValue] : m_counters)
+		{
+			if (counterName == name)
+			{
+				counterValue = value;
+				return;
+			}
+		}
+		m_counters.emplace_back(name, value);
+	}
+
+	// Adds phases and counters of another job to the ones of the same names, so a batch of jobs
+	// is reported as one. Process peak RSS of a phase is the max of them
+	void Merge(const JobStats& other)
+	{
+		for (auto& otherPhase : other.m_phases)
+		{
+			auto phase = std::find_if(m_phases.begin(), m_phases.end(), [&](const Phase& item) {
+				return item.m_name == otherPhase.m_name;
+			});
+			if (phase == m_phases.end())
+			{
+				m_phases.push_back(otherPhase);
+				continue;
+			}
+
+			phase->m_wallSeconds += otherPhase.m_wallSeconds;
+			phase->m_cpuSeconds += otherPhase.m_cpuSeconds;
+			phase->m_processPeakRssBytes = std::max(phase->m_processPeakRssBytes, otherPhase.m_processPeakRssBytes);
+			phase->m_peakRssGrowthBytes += otherPhase.m_peakRssGrowthBytes;
+			for (size_t i = 0; i < phase->m_counters.size(); ++i)
+			{
+				phase->m_counters[i] += otherPhase.m_counters[i];
+			}
+		}
+
+		for (auto& [name, value] : other.m_counters)
+		{
+			auto counter = std::find_if(m_counters.begin(), m_counters.end(), [&](const auto& item) {
+				return item.first == name;
+			});
+			if (counter == m_counters.end())
+			{
+				m_counters.emplace_back(name, value);
+			}
+			else
+			{
+				counter->second += value;
+			}
+		}
+	}
+
+	const Phases& GetPhases() const noexcept
+	{
+		return m_phases;
+	}
+
+	const Counters& GetCounters() const noexcept
+	{
+		return m_counters;
+	}
+
+	// Names of phases and counters are identifiers given by the code, so they are written without escaping
+	void WriteJson(std::ostream& output) const
+	{
+		double wallSeconds = 0;
+		double cpuSeconds = 0;
+		for (auto& phase : m_phases)
+		{
+			wallSeconds += phase.m_wallSeconds;
+			cpuSeconds += phase.m_cpuSeconds;
+		}
+
+		output << "{\n"
+			<< "  \"wall_seconds\": " << wallSeconds << ",\n"
+			<< "  \"cpu_seconds\": " << cpuSeconds << ",\n"
+			<< "  \"process_peak_rss_bytes\": " << GetPeakRssBytes() << ",\n"
+			<< "  \"phases\": [";
+		for (size_t i = 0; i < m_phases.size(); ++i)
+		{
+			auto& phase = m_phases[i];
+			output << (i == 0 ? "\n" : ",\n")
+				<< "    { \"name\": \"" << phase.m_name << '"'
+				<< ", \"wall_seconds\": " << phase.m_wallSeconds
+				<< ", \"cpu_seconds\": " << phase.m_cpuSeconds
+				<< ", \"process_peak_rss_bytes\": " << phase.m_processPeakRssBytes
+				<< ", \"peak_rss_growth_bytes\": " << phase.m_peakRssGrowthBytes;
+			for (size_t counter = 0; counter < phase.m_counters.size(); ++counter)
+			{
+				output << ", \"" << StatsCounters::GetName(static_cast<StatsCounter>(counter)) << "\": " << phase.m_counters[counter];
+			}
+			output << " }";
+		}
+		output << (m_phases.empty() ? "],\n" : "\n  ],\n")
+			<< "  \"counters\": {";
+		for (size_t i = 0; i < m_counters.size(); ++i)
+		{
+			output << (i == 0 ? " \"" : ", \"") << m_counters[i].first << "\": " << m_counters[i].second;
+		}
+		output << (m_counters.empty() ? "}\n" : " }\n")
+			<< "}\n";
+	}
+
+private:
+	// Takes readings on construction and records their differences as a phase on destruction
+	class PhaseScope
+	{
+	public:
+		PhaseScope(JobStats& stats, std::string_view name)
+			: m_stats(stats)
+			, m_name(name)
+			, m_wallStart(std::chrono::steady_clock::now())
+			, m_cpuStart(GetProcessCpuSeconds())
+			, m_peakRssStart(GetPeakRssBytes())
+			, m_countersStart(ReadCounters())
+		{
+		}
+
+		PhaseScope(const PhaseScope&) = delete;
+		PhaseScope& operator=(const PhaseScope&) = delete;
+
+		~PhaseScope()
+		{
+			auto counters = ReadCounters();
+			for (size_t i = 0; i < counters.size(); ++i)
+			{
+				counters[i] -= m_countersStart[i];
+			}
+
+			auto peakRss = GetPeakRssBytes();
+
+			try
+			{
+				m_stats.m_phases.push_back(Phase{
+					std::move(m_name),
+					std::chrono::duration<double>(std::chrono::steady_clock::now() - m_wallStart).count(),
+					GetProcessCpuSeconds() - m_cpuStart,
+					peakRss,
+					peakRss - std::min(peakRss, m_peakRssStart),
+					counters });
+			}
+			catch (...)
+			{
+			}
+		}
+
+	private:
+		static std::array<std::uint64_t, static_cast<size_t>(StatsCounter::COUNT)> ReadCounters() noexcept
+		{
+			std::array<std::uint64_t, static_cast<size_t>(StatsCounter::COUNT)> result{};
+			for (size_t i = 0; i < result.size(); ++i)
+			{
+				result[i] = StatsCounters::Get(static_cast<StatsCounter>(i));
+			}
+			return result;
+		}
+
+		JobStats& m_stats;
+		std::string m_name;
+		std::chrono::steady_clock::time_point m_wallStart;
+		double m_cpuStart;
+		std::uint64_t m_peakRssStart;
+		std::array<std::uint64_t, static_cast<size_t>(StatsCounter::COUNT)> m_countersStart;
+	};
+
+	Phases m_phases;
+	Counters m_counters;
+};
+
+#endif // !AUTOMATA_STATS_HPP_
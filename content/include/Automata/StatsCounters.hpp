@@ -0,0 +1,54 @@
+#ifndef AUTOMATA_STATS_COUNTERS_HPP_
+#define AUTOMATA_STATS_COUNTERS_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+enum class StatsCounter : size_t
+{
+	// Calls of global operator new, counted only by binaries that replace it
+	ALLOCATIONS = 0,
+	// Rounds of ParallelPartition, which minimizes on more than one thread only
+	PARALLEL_REFINEMENT_ROUNDS,
+	// Splitters processed by HopcroftPartition, which minimizes on one thread only
+	HOPCROFT_SPLITTERS,
+	COUNT,
+};
+
+// Process-wide event counters. Library code adds to them from any thread with one relaxed atomic add,
+// so they stay on in every build; jobs read them before and after their phases
+class StatsCounters
+{
+public:
+	static void Add(StatsCounter counter, std::uint64_t value = 1) noexcept
+	{
+		m_values[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+	}
+
+	static std::uint64_t Get(StatsCounter counter) noexcept
+	{
+		return m_values[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+	}
+
+	static constexpr std::string_view GetName(StatsCounter counter) noexcept
+	{
+		switch (counter)
+		{
+		case StatsCounter::ALLOCATIONS:
+			return "allocations";
+		case StatsCounter::PARALLEL_REFINEMENT_ROUNDS:
+			return "parallel_refinement_rounds";
+		case StatsCounter::HOPCROFT_SPLITTERS:
+			return "hopcroft_splitters";
+		default:
+			return "";
+		}
+	}
+
+private:
+	inline static std::array<std::atomic<std::uint64_t>, static_cast<size_t>(StatsCounter::COUNT)> m_values{};
+};
+
+#endif // !AUTOMATA_STATS_COUNTERS_HPP_
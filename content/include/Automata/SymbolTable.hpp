@@ -0,0 +1,123 @@
+#ifndef AUTOMATA_SYMBOL_TABLE_HPP_
+#define AUTOMATA_SYMBOL_TABLE_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Interns distinct names of states|signals into dense ids 0..N-1 in order of their first appearance.
+// Engines work on ids only, original spelling is kept for output
+class SymbolTable
+{
+public:
+	using Id = std::uint32_t;
+	using Names = std::vector<std::string>;
+
+	SymbolTable() = default;
+
+	// Table of names label + 0, label + 1, ..., label + (count - 1)
+	static SymbolTable MakeIndexed(char label, size_t count)
+	{
+		SymbolTable result{};
+		result.m_names.reserve(count);
+		result.m_ids.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			result.Intern(label + std::to_string(i));
+		}
+
+		return result;
+	}
+
+	Id Intern(std::string_view name)
+	{
+		if (auto it = m_ids.find(name); it != m_ids.end())
+		{
+			return it->second;
+		}
+
+		auto id = static_cast<Id>(m_names.size());
+		m_names.emplace_back(name);
+		m_ids.emplace(m_names.back(), id);
+
+		return id;
+	}
+
+	// Interns name that must not be met before
+	Id InternUnique(std::string_view name)
+	{
+		auto sizeBefore = m_names.size();
+		auto id = Intern(name);
+		if (m_names.size() == sizeBefore)
+		{
+			throw std::invalid_argument("SymbolTable already contains name " + std::string(name));
+		}
+
+		return id;
+	}
+
+	std::optional<Id> FindId(std::string_view name) const
+	{
+		if (auto it = m_ids.find(name); it != m_ids.end())
+		{
+			return it->second;
+		}
+
+		return std::nullopt;
+	}
+
+	const std::string& GetName(Id id) const
+	{
+		return m_names[id];
+	}
+
+	const Names& GetNames() const noexcept
+	{
+		return m_names;
+	}
+
+	size_t GetSize() const noexcept
+	{
+		return m_names.size();
+	}
+
+	bool IsEmpty() const noexcept
+	{
+		return m_names.empty();
+	}
+
+	// Table made of given ids in given order, ids are renumbered from 0
+	SymbolTable Select(const std::vector<size_t>& ids) const
+	{
+		SymbolTable result{};
+		result.m_names.reserve(ids.size());
+		result.m_ids.reserve(ids.size());
+		for (auto id : ids)
+		{
+			result.Intern(m_names[id]);
+		}
+
+		return result;
+	}
+
+private:
+	struct NameHash
+	{
+		using is_transparent = void;
+
+		size_t operator()(std::string_view name) const noexcept
+		{
+			return std::hash<std::string_view>{}(name);
+		}
+	};
+
+	Names m_names;
+	std::unordered_map<std::string, Id, NameHash, std::equal_to<>> m_ids;
+};
+
+#endif // !AUTOMATA_SYMBOL_TABLE_HPP_
@@ -0,0 +1,73 @@
+#ifndef AUTOMATA_TABLE_FIELDS_HPP_
+#define AUTOMATA_TABLE_FIELDS_HPP_
+
+#include <string_view>
+
+// Splits ';'-separated automaton table into lines and fields in place, without copying them.
+// Empty lines are skipped, trailing '\r' of Windows line endings is dropped
+class TableScanner
+{
+public:
+	static constexpr char DELIMETER = ';';
+
+	constexpr explicit TableScanner(std::string_view content) noexcept
+		: m_content(content)
+	{
+	}
+
+	constexpr bool ReadLine(std::string_view& line) noexcept
+	{
+		while (!m_content.empty())
+		{
+			auto lineEnd = m_content.find('\n');
+			line = m_content.substr(0, lineEnd);
+			m_content.remove_prefix(lineEnd == m_content.npos ? m_content.size() : lineEnd + 1);
+
+			if (!line.empty() && line.back() == '\r')
+			{
+				line.remove_suffix(1);
+			}
+			if (!line.empty())
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+private:
+	std::string_view m_content;
+};
+
+// Iterates fields of one line: for (FieldsRange fields{ line }; fields.Next(field);)
+class FieldsRange
+{
+public:
+	constexpr explicit FieldsRange(std::string_view line) noexcept
+		: m_line(line)
+		, m_hasMore(true)
+	{
+	}
+
+	constexpr bool Next(std::string_view& field) noexcept
+	{
+		if (!m_hasMore)
+		{
+			return false;
+		}
+
+		auto fieldEnd = m_line.find(TableScanner::DELIMETER);
+		field = m_line.substr(0, fieldEnd);
+		m_hasMore = fieldEnd != m_line.npos;
+		m_line.remove_prefix(m_hasMore ? fieldEnd + 1 : m_line.size());
+
+		return true;
+	}
+
+private:
+	std::string_view m_line;
+	bool m_hasMore;
+};
+
+#endif // !AUTOMATA_TABLE_FIELDS_HPP_
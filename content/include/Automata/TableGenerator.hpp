@@ -0,0 +1,269 @@
+#ifndef AUTOMATA_TABLE_GENERATOR_HPP_
+#define AUTOMATA_TABLE_GENERATOR_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "MealyMooreTable.hpp"
+#include "NfaTable.hpp"
+
+namespace generator_excps
+{
+
+constexpr auto EMPTY_TABLE_MSG = "Failed to generate table. States, inputs, signals and copies counts must be positive";
+constexpr auto WRONG_SHARE_MSG = "Failed to generate table. Shares must be in [0, 1]";
+constexpr auto TOO_BIG_TABLE_MSG = "Failed to generate table. Table cells count exceeds id range";
+constexpr auto NO_TARGETS_MSG = "Failed to generate NFA. Max targets count of a cell must be positive";
+
+}; // namespace generator_excps
+
+struct GeneratorParams
+{
+	size_t m_statesCount = 1000;
+	size_t m_inputsCount = 4;
+	size_t m_signalsCount = 2;
+	// Share of states reachable from the start state 0, the rest are reachable only from each other
+	double m_reachableShare = 1.0;
+	// NFA only: max count of targets of a cell and share of states with an epsilon transition
+	size_t m_maxTargetsCount = 2;
+	double m_epsilonShare = 0.1;
+	// Mealy and Moore only: the table of m_statesCount states is repeated m_copiesCount times, and every
+	// transition leads to a random copy of its target. Copies of a state are equivalent, so minimization
+	// merges them into the states of the table of one copy
+	size_t m_copiesCount = 1;
+	std::uint32_t m_seed = 42;
+};
+
+// Random tables of given size for benchmarks and tests. The same parameters give the same table
+// on every platform, as only std::mt19937 output is used.
+// States are named q<i>, inputs z<i>, signals of Mealy tables w<i> and of Moore tables y<i>
+class TableGenerator
+{
+public:
+	using Id = TransitionMatrix::Id;
+
+	explicit TableGenerator(const GeneratorParams& params)
+		: m_params(params)
+		, m_reachableCount()
+		, m_random()
+	{
+		if (m_params.m_statesCount == 0 || m_params.m_inputsCount == 0 || m_params.m_signalsCount == 0 || m_params.m_copiesCount == 0)
+		{
+			throw std::invalid_argument(generator_excps::EMPTY_TABLE_MSG);
+		}
+		if (!(m_params.m_reachableShare >= 0 && m_params.m_reachableShare <= 1)
+			|| !(m_params.m_epsilonShare >= 0 && m_params.m_epsilonShare <= 1))
+		{
+			throw std::invalid_argument(generator_excps::WRONG_SHARE_MSG);
+		}
+		if (m_params.m_statesCount > std::numeric_limits<Id>::max() / m_params.m_inputsCount / m_params.m_copiesCount)
+		{
+			throw std::length_error(generator_excps::TOO_BIG_TABLE_MSG);
+		}
+
+		m_reachableCount = std::max<size_t>(1, static_cast<size_t>(std::llround(m_params.m_reachableShare * m_params.m_statesCount)));
+	}
+
+	MealyTable MakeMealyTable()
+	{
+		m_random.seed(m_params.m_seed);
+
+		auto targets = MakeTargets();
+		TransitionMatrix outputs{ m_params.m_inputsCount, m_params.m_statesCount };
+		for (size_t input = 0; input < m_params.m_inputsCount; ++input)
+		{
+			for (size_t state = 0; state < m_params.m_statesCount; ++state)
+			{
+				outputs.At(input, state) = GetRandomId(m_params.m_signalsCount);
+			}
+		}
+
+		return MealyTable{
+			SymbolTable::MakeIndexed('q', m_params.m_statesCount * m_params.m_copiesCount),
+			SymbolTable::MakeIndexed('z', m_params.m_inputsCount),
+			SymbolTable::MakeIndexed('w', m_params.m_signalsCount),
+			CopyTargets(targets),
+			CopyColumns(outputs)
+		};
+	}
+
+	MooreTable MakeMooreTable()
+	{
+		m_random.seed(m_params.m_seed);
+
+		auto targets = MakeTargets();
+		MooreTable::StateSignals stateSignals(m_params.m_statesCount);
+		for (auto& signal : stateSignals)
+		{
+			signal = GetRandomId(m_params.m_signalsCount);
+		}
+
+		MooreTable::StateSignals copiedSignals{};
+		copiedSignals.reserve(stateSignals.size() * m_params.m_copiesCount);
+		for (size_t copy = 0; copy < m_params.m_copiesCount; ++copy)
+		{
+			copiedSignals.insert(copiedSignals.end(), stateSignals.begin(), stateSignals.end());
+		}
+
+		return MooreTable{
+			SymbolTable::MakeIndexed('y', m_params.m_signalsCount),
+			copiedSignals,
+			SymbolTable::MakeIndexed('q', m_params.m_statesCount * m_params.m_copiesCount),
+			SymbolTable::MakeIndexed('z', m_params.m_inputsCount),
+			CopyTargets(targets)
+		};
+	}
+
+	// Every cell has 1..m_maxTargetsCount targets, one of them is the target of a random DFA with the same
+	// reachability. Accept tags are 0..m_signalsCount, so signals count is the count of tokens
+	NfaTable MakeNfaTable()
+	{
+		if (m_params.m_maxTargetsCount == 0)
+		{
+			throw std::invalid_argument(generator_excps::NO_TARGETS_MSG);
+		}
+		m_random.seed(m_params.m_seed);
+
+		const auto statesCount = m_params.m_statesCount;
+		const auto inputsCount = m_params.m_inputsCount;
+		auto dfaTargets = MakeTargets();
+
+		NfaTargets::Ids offsets{ 0 };
+		NfaTargets::Ids targets{};
+		offsets.reserve(inputsCount * statesCount + 1);
+		for (size_t input = 0; input < inputsCount; ++input)
+		{
+			for (size_t state = 0; state < statesCount; ++state)
+			{
+				targets.push_back(dfaTargets.At(input, state));
+				for (auto count = m_random() % m_params.m_maxTargetsCount; count > 0; --count)
+				{
+					targets.push_back(GetRandomTarget(state));
+				}
+				offsets.push_back(static_cast<Id>(targets.size()));
+			}
+		}
+
+		NfaTargets::Ids epsilonOffsets{ 0 };
+		NfaTargets::Ids epsilonTargets{};
+		epsilonOffsets.reserve(statesCount + 1);
+		for (size_t state = 0; state < statesCount; ++state)
+		{
+			if (m_random() < m_params.m_epsilonShare * (double{ std::mt19937::max() } + 1))
+			{
+				epsilonTargets.push_back(GetRandomTarget(state));
+			}
+			epsilonOffsets.push_back(static_cast<Id>(epsilonTargets.size()));
+		}
+
+		NfaTable::AcceptTags acceptTags(statesCount);
+		for (auto& tag : acceptTags)
+		{
+			tag = GetRandomId(m_params.m_signalsCount + 1);
+		}
+
+		return NfaTable{
+			SymbolTable::MakeIndexed('q', statesCount),
+			SymbolTable::MakeIndexed('z', inputsCount),
+			acceptTags,
+			NfaTargets{ inputsCount, statesCount, std::move(offsets), std::move(targets) },
+			NfaTargets{ 1, statesCount, std::move(epsilonOffsets), std::move(epsilonTargets) }
+		};
+	}
+
+private:
+	Id GetRandomId(size_t count)
+	{
+		return static_cast<Id>(m_random() % count);
+	}
+
+	// Reachable states lead to reachable states only, unreachable ones lead anywhere
+	Id GetRandomTarget(size_t state)
+	{
+		return GetRandomId(state < m_reachableCount ? m_reachableCount : m_params.m_statesCount);
+	}
+
+	// States 0..m_reachableCount - 1 are reached from state 0 through a random spanning tree
+	TransitionMatrix MakeTargets()
+	{
+		const auto statesCount = m_params.m_statesCount;
+		const auto inputsCount = m_params.m_inputsCount;
+
+		TransitionMatrix result{ inputsCount, statesCount };
+		for (size_t input = 0; input < inputsCount; ++input)
+		{
+			for (size_t state = 0; state < statesCount; ++state)
+			{
+				result.At(input, state) = GetRandomTarget(state);
+			}
+		}
+
+		// Cells of already reached states that aren't tree edges, as input * statesCount + state
+		std::vector<Id> freeCells{};
+		auto addCells = [&](size_t state) {
+			for (size_t input = 0; input < inputsCount; ++input)
+			{
+				freeCells.push_back(static_cast<Id>(input * statesCount + state));
+			}
+		};
+		addCells(0);
+		for (size_t state = 1; state < m_reachableCount; ++state)
+		{
+			auto i = GetRandomId(freeCells.size());
+			auto cell = freeCells[i];
+			freeCells[i] = freeCells.back();
+			freeCells.pop_back();
+
+			result.At(cell / statesCount, cell % statesCount) = static_cast<Id>(state);
+			addCells(state);
+		}
+
+		return result;
+	}
+
+	// State of copy c is state + c * statesCount. Tables of one copy are kept as they are,
+	// so m_copiesCount = 1 doesn't change the random sequence
+	TransitionMatrix CopyTargets(const TransitionMatrix& targets)
+	{
+		if (m_params.m_copiesCount == 1)
+		{
+			return targets;
+		}
+
+		const auto statesCount = m_params.m_statesCount;
+		auto result = CopyColumns(targets);
+		for (size_t input = 0; input < m_params.m_inputsCount; ++input)
+		{
+			for (size_t state = 0; state < result.GetStatesCount(); ++state)
+			{
+				result.At(input, state) += static_cast<Id>(statesCount * GetRandomId(m_params.m_copiesCount));
+			}
+		}
+		return result;
+	}
+
+	TransitionMatrix CopyColumns(const TransitionMatrix& matrix) const
+	{
+		const auto statesCount = m_params.m_statesCount;
+		TransitionMatrix result{ m_params.m_inputsCount, statesCount * m_params.m_copiesCount };
+		for (size_t input = 0; input < m_params.m_inputsCount; ++input)
+		{
+			for (size_t state = 0; state < result.GetStatesCount(); ++state)
+			{
+				result.At(input, state) = matrix.At(input, state % statesCount);
+			}
+		}
+		return result;
+	}
+
+	GeneratorParams m_params;
+	size_t m_reachableCount;
+	std::mt19937 m_random;
+};
+
+#endif // !AUTOMATA_TABLE_GENERATOR_HPP_
@@ -0,0 +1,145 @@
+#ifndef AUTOMATA_TABLE_SCANNER_HPP_
+#define AUTOMATA_TABLE_SCANNER_HPP_
+
+#include <cstdio>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "../CSV/csv.hpp"
+#include "TableFields.hpp"
+
+namespace scanner_excps
+{
+
+constexpr auto FAILED_OPEN_FILE_MSG = "Failed to open file ";
+constexpr auto FAILED_MAP_FILE_MSG = "Failed to map file ";
+constexpr auto FAILED_READ_STREAM_MSG = "Failed to read input stream";
+
+}; // namespace scanner_excps
+
+// Read-only memory mapping of a whole file. Content stays valid while the object lives
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::string& fileName)
+		: m_source()
+	{
+		std::error_code error{};
+		auto size = std::filesystem::file_size(fileName, error);
+		if (error)
+		{
+			throw std::runtime_error(scanner_excps::FAILED_OPEN_FILE_MSG + fileName);
+		}
+		if (size == 0)
+		{
+			return;
+		}
+
+		m_source = mio::make_mmap_source(fileName, error);
+		if (error)
+		{
+			throw std::runtime_error(scanner_excps::FAILED_MAP_FILE_MSG + fileName);
+		}
+	}
+
+	std::string_view GetContent() const noexcept
+	{
+		return m_source.is_mapped()
+			? std::string_view{ m_source.data(), m_source.size() }
+			: std::string_view{};
+	}
+
+private:
+	mio::mmap_source m_source;
+};
+
+// Reads a stream by chunks of whole lines. The next chunk is read on another thread while
+// the caller processes the current one, so reading a pipe overlaps with parsing
+class ChunkedReader
+{
+public:
+	static constexpr size_t CHUNK_SIZE = 1 << 20;
+
+	explicit ChunkedReader(std::FILE* file)
+		: m_file(file)
+		, m_chunk()
+		, m_chunkSize()
+		, m_next(ReadBlockAsync())
+	{
+	}
+
+	ChunkedReader(const ChunkedReader&) = delete;
+	ChunkedReader& operator=(const ChunkedReader&) = delete;
+
+	~ChunkedReader()
+	{
+		if (m_next.valid())
+		{
+			m_next.wait();
+		}
+	}
+
+	// Returns false at the end of the stream. Chunk stays valid until the next call
+	bool ReadChunk(std::string_view& chunk)
+	{
+		// Tail of the previous block after its last line end starts the chunk
+		m_chunk.erase(0, m_chunkSize);
+		while (m_next.valid())
+		{
+			auto block = m_next.get();
+			auto isLast = block.empty();
+			if (!isLast)
+			{
+				m_next = ReadBlockAsync();
+			}
+			m_chunk += block;
+
+			auto lineEnd = m_chunk.rfind('\n');
+			if (isLast || lineEnd != m_chunk.npos)
+			{
+				m_chunkSize = isLast ? m_chunk.size() : lineEnd + 1;
+				chunk = std::string_view{ m_chunk }.substr(0, m_chunkSize);
+				return !chunk.empty();
+			}
+		}
+
+		m_chunkSize = m_chunk.size();
+		return false;
+	}
+
+	// Reads the rest of the stream, for formats that need the whole content
+	std::string ReadAll()
+	{
+		std::string result{};
+		for (std::string_view chunk{}; ReadChunk(chunk);)
+		{
+			result += chunk;
+		}
+		return result;
+	}
+
+private:
+	std::future<std::string> ReadBlockAsync()
+	{
+		return std::async(std::launch::async, [file = m_file] {
+			std::string result(CHUNK_SIZE, '\0');
+			result.resize(std::fread(result.data(), 1, result.size(), file));
+			if (result.empty() && std::ferror(file))
+			{
+				throw std::runtime_error(scanner_excps::FAILED_READ_STREAM_MSG);
+			}
+			return result;
+		});
+	}
+
+	std::FILE* m_file;
+	std::string m_chunk;
+	size_t m_chunkSize;
+	std::future<std::string> m_next;
+};
+
+#endif // !AUTOMATA_TABLE_SCANNER_HPP_
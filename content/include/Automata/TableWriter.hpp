@@ -0,0 +1,216 @@
+#ifndef AUTOMATA_TABLE_WRITER_HPP_
+#define AUTOMATA_TABLE_WRITER_HPP_
+
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "MealyMooreTable.hpp"
+#include "NfaTable.hpp"
+#include "NfaTableReader.hpp"
+
+// Serializes tables into a reusable buffer and hands it to the stream with big unformatted writes,
+// so neither locale nor per-field sentries are involved. Output matches operator<< of the tables
+class TableWriter
+{
+public:
+	static constexpr size_t BUFFER_SIZE = 1 << 20;
+	static constexpr char DELIMETER = ';';
+
+	explicit TableWriter(std::ostream& output)
+		: m_output(output)
+		, m_buffer(BUFFER_SIZE)
+		, m_size()
+	{
+	}
+
+	TableWriter(const TableWriter&) = delete;
+	TableWriter& operator=(const TableWriter&) = delete;
+
+	~TableWriter()
+	{
+		try
+		{
+			Flush();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	void Write(const MealyTable& table)
+	{
+		const auto& states = table.GetStates();
+		const auto& signals = table.GetSignals();
+		const auto& targets = table.GetTargets();
+		const auto& outputs = table.GetOutputs();
+
+		for (auto& columnName : states.GetNames())
+		{
+			Append(DELIMETER);
+			Append(columnName);
+		}
+
+		size_t rowIndex = 0;
+		for (auto& transition : table.GetTransitions().GetNames())
+		{
+			Append('\n');
+			Append(transition);
+
+			auto targetsRow = targets.GetRow(rowIndex);
+			auto outputsRow = outputs.GetRow(rowIndex);
+			for (size_t stateIndex = 0; stateIndex < states.GetSize(); ++stateIndex)
+			{
+				Append(DELIMETER);
+				Append(states.GetName(targetsRow[stateIndex]));
+				Append('/');
+				Append(signals.GetName(outputsRow[stateIndex]));
+			}
+			++rowIndex;
+		}
+		Append('\n');
+
+		Flush();
+	}
+
+	void Write(const MooreTable& table)
+	{
+		const auto& states = table.GetStates();
+		const auto& signals = table.GetSignals();
+		const auto& targets = table.GetTargets();
+
+		for (auto signal : table.GetStateSignals())
+		{
+			Append(DELIMETER);
+			Append(signals.GetName(signal));
+		}
+		Append('\n');
+
+		for (auto& state : states.GetNames())
+		{
+			Append(DELIMETER);
+			Append(state);
+		}
+
+		size_t rowIndex = 0;
+		for (auto& transition : table.GetTransitions().GetNames())
+		{
+			Append('\n');
+			Append(transition);
+
+			auto targetsRow = targets.GetRow(rowIndex);
+			for (size_t stateIndex = 0; stateIndex < states.GetSize(); ++stateIndex)
+			{
+				Append(DELIMETER);
+				Append(states.GetName(targetsRow[stateIndex]));
+			}
+			++rowIndex;
+		}
+		Append('\n');
+
+		Flush();
+	}
+
+	// Format of NfaTableReader, which has final marks only, so every non-zero accept tag is written as a mark
+	void Write(const NfaTable& table)
+	{
+		const auto& states = table.GetStates();
+
+		for (auto tag : table.GetAcceptTags())
+		{
+			Append(DELIMETER);
+			Append(tag == 0 ? std::string_view{} : NfaTableReader::FINAL_MARK);
+		}
+		Append('\n');
+
+		for (auto& state : states.GetNames())
+		{
+			Append(DELIMETER);
+			Append(state);
+		}
+
+		size_t rowIndex = 0;
+		for (auto& transition : table.GetTransitions().GetNames())
+		{
+			Append('\n');
+			Append(transition);
+			AppendNfaRow(states, table.GetTargets(), rowIndex++);
+		}
+		Append('\n');
+		Append(NfaTableReader::EPSILON);
+		AppendNfaRow(states, table.GetEpsilonTargets(), 0);
+		Append('\n');
+
+		Flush();
+	}
+
+	void Flush()
+	{
+		WriteBuffer();
+		m_output.flush();
+
+		if (!m_output)
+		{
+			throw std::runtime_error("Failed to write table to output");
+		}
+	}
+
+private:
+	void WriteBuffer()
+	{
+		if (m_size != 0)
+		{
+			m_output.write(m_buffer.data(), static_cast<std::streamsize>(m_size));
+			m_size = 0;
+		}
+	}
+
+	void Append(char ch)
+	{
+		if (m_size == m_buffer.size())
+		{
+			WriteBuffer();
+		}
+		m_buffer[m_size++] = ch;
+	}
+
+	void Append(std::string_view str)
+	{
+		if (m_size + str.size() > m_buffer.size())
+		{
+			WriteBuffer();
+			if (str.size() > m_buffer.size())
+			{
+				m_output.write(str.data(), static_cast<std::streamsize>(str.size()));
+				return;
+			}
+		}
+		std::memcpy(m_buffer.data() + m_size, str.data(), str.size());
+		m_size += str.size();
+	}
+
+	void AppendNfaRow(const SymbolTable& states, const NfaTargets& targets, size_t row)
+	{
+		for (size_t stateIndex = 0; stateIndex < states.GetSize(); ++stateIndex)
+		{
+			Append(DELIMETER);
+			auto cell = targets.At(row, stateIndex);
+			for (size_t i = 0; i < cell.size(); ++i)
+			{
+				if (i != 0)
+				{
+					Append(NfaTableReader::TARGETS_DELIMETER);
+				}
+				Append(states.GetName(cell[i]));
+			}
+		}
+	}
+
+	std::ostream& m_output;
+	std::vector<char> m_buffer;
+	size_t m_size;
+};
+
+#endif // !AUTOMATA_TABLE_WRITER_HPP_
@@ -0,0 +1,104 @@
+#ifndef AUTOMATA_TRANSITION_MATRIX_HPP_
+#define AUTOMATA_TRANSITION_MATRIX_HPP_
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Dense input-major matrix of ids: the cell of (input, state) lives at input * statesCount + state,
+// so a whole row of one input is contiguous and any cell is reached with a single multiply-add
+class TransitionMatrix
+{
+public:
+	using Id = std::uint32_t;
+	using Cells = std::vector<Id>;
+
+	TransitionMatrix() = default;
+
+	TransitionMatrix(size_t inputsCount, size_t statesCount)
+		: m_inputsCount(inputsCount)
+		, m_statesCount(statesCount)
+		, m_cells(inputsCount * statesCount)
+	{
+	}
+
+	TransitionMatrix(size_t inputsCount, size_t statesCount, Cells&& cells)
+		: m_inputsCount(inputsCount)
+		, m_statesCount(statesCount)
+		, m_cells(std::move(cells))
+	{
+		if (m_cells.size() != inputsCount * statesCount)
+		{
+			throw std::invalid_argument("TransitionMatrix must contain inputsCount * statesCount cells");
+		}
+	}
+
+	Id& At(size_t input, size_t state) noexcept
+	{
+		return m_cells[input * m_statesCount + state];
+	}
+
+	Id At(size_t input, size_t state) const noexcept
+	{
+		return m_cells[input * m_statesCount + state];
+	}
+
+	const Id* GetRow(size_t input) const noexcept
+	{
+		return m_cells.data() + input * m_statesCount;
+	}
+
+	size_t GetInputsCount() const noexcept
+	{
+		return m_inputsCount;
+	}
+
+	size_t GetStatesCount() const noexcept
+	{
+		return m_statesCount;
+	}
+
+	const Cells& GetCells() const noexcept
+	{
+		return m_cells;
+	}
+
+	// Matrix made of given columns in given order
+	TransitionMatrix SelectColumns(const std::vector<size_t>& columns) const
+	{
+		TransitionMatrix result{ m_inputsCount, columns.size() };
+
+		for (size_t input = 0; input < m_inputsCount; ++input)
+		{
+			auto row = GetRow(input);
+			auto resultRow = result.m_cells.data() + input * columns.size();
+			for (size_t i = 0; i < columns.size(); ++i)
+			{
+				resultRow[i] = row[columns[i]];
+			}
+		}
+
+		return result;
+	}
+
+	// Replaces every id in the matrix with idMap[id]
+	void RemapIds(const std::vector<Id>& idMap)
+	{
+		for (auto& cell : m_cells)
+		{
+			if (cell >= idMap.size())
+			{
+				throw std::out_of_range("TransitionMatrix contains id that is out of given map");
+			}
+			cell = idMap[cell];
+		}
+	}
+
+private:
+	size_t m_inputsCount{};
+	size_t m_statesCount{};
+	Cells m_cells;
+};
+
+#endif // !AUTOMATA_TRANSITION_MATRIX_HPP_
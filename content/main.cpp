@@ -1,77 +1,445 @@
 #include "include/pch.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
 #include "include/ArgParse/ParseArgs.h"
 
 #include "include/Automata/MealyTableReader.hpp"
 #include "include/Automata/MooreTableReader.hpp"
+#include "include/Automata/NfaTableReader.hpp"
 
+#include "include/Automata/BinaryTable.hpp"
+#include "include/Automata/CodeWriter.hpp"
+#include "include/Automata/Determinization.hpp"
 #include "include/Automata/MealyMooreTable.hpp"
+#include "include/Automata/Regex.hpp"
+#include "include/Automata/Stats.hpp"
+#include "include/Automata/TableWriter.hpp"
 
-int main(int argc, char* argv[])
+constexpr auto FAILED_WRITE_FILE_MSG = "Failed to write file ";
+constexpr auto DUPLICATE_OUTPUT_MSG = "Failed to read batch. Several jobs write file ";
+
+// Binary tables are recognized by their header and loaded without parsing
+MealyTable ReadMealyTable(std::string_view content)
 {
-	auto program = ParseArgs(argc, argv);
+	if (IsBinaryTable(content))
+	{
+		return BinaryTableView{ content }.ToMealyTable();
+	}
 
-	auto& inputFileName = program.get(INPUT_FILE_PAR);
-	auto& outputFileName = program.get(OUTPUT_FILE_PAR);
+	auto mealyTableReader = MealyTableReader{ content };
+	return MealyTable{
+		mealyTableReader.GetStates(),
+		mealyTableReader.GetTransitions(),
+		mealyTableReader.GetSignals(),
+		mealyTableReader.GetTargets(),
+		mealyTableReader.GetOutputs()
+	};
+}
 
-	auto& mode = program.get<ProgramMode>(MODE_PAR);
+MooreTable ReadMooreTable(std::string_view content)
+{
+	if (IsBinaryTable(content))
+	{
+		return BinaryTableView{ content }.ToMooreTable();
+	}
+
+	auto mooreTableReader = MooreTableReader{ content };
+	return MooreTable{
+		mooreTableReader.GetSignals(),
+		mooreTableReader.GetStateSignals(),
+		mooreTableReader.GetStates(),
+		mooreTableReader.GetTransitions(),
+		mooreTableReader.GetTargets()
+	};
+}
 
+// Calls write for the output stream. "-" is stdout, a file is written as <file>.tmp and replaces the file
+// only once written completely, so a failed job doesn't leave an empty or partial file in place of a previous one
+template <typename Write>
+void WriteOutput(const std::string& fileName, bool binary, Write&& write)
+{
+	if (fileName == STD_STREAM_NAME)
+	{
+		write(std::cout);
+		return;
+	}
+
+	auto tempFileName = fileName + ".tmp";
 	try
 	{
-		auto reader = csv::CSVReader(inputFileName);
-		std::ofstream oFS{ outputFileName };
+		std::ofstream outputFile{ tempFileName, binary ? std::ios::binary : std::ios::out };
+		if (!outputFile)
+		{
+			throw std::runtime_error(scanner_excps::FAILED_OPEN_FILE_MSG + tempFileName);
+		}
+		write(outputFile);
+		outputFile.close();
+		if (!outputFile)
+		{
+			throw std::runtime_error(FAILED_WRITE_FILE_MSG + fileName);
+		}
+		std::filesystem::rename(tempFileName, fileName);
+	}
+	catch (...)
+	{
+		std::error_code error{};
+		std::filesystem::remove(tempFileName, error);
+		throw;
+	}
+}
+
+struct JobOptions
+{
+	ProgramMode m_mode;
+	size_t m_threadsCount;
+	bool m_binaryOutput;
+	// Regex mode only, <output-file>.classes if empty
+	std::string m_byteClassesFileName;
+};
 
-		if (mode == ProgramMode::MEALY_MIN)
+// Reads the input file, transforms its automaton by the mode and writes the result. Throws on failure
+void RunJob(const JobOptions& options, const std::string& inputFileName, const std::string& outputFileName, JobStats& stats)
+{
+	// "-" is stdin or stdout. Regex patterns are compiled chunk by chunk while the next chunk is read,
+	// tables are parsed once the whole stream is read
+	auto fromStdin = inputFileName == STD_STREAM_NAME;
+	auto toStdout = outputFileName == STD_STREAM_NAME;
+
+	std::optional<MappedFile> inputFile{};
+	if (!fromStdin)
+	{
+		inputFile.emplace(inputFileName);
+	}
+	std::string inputBuffer{};
+	auto getContent = [&]() -> std::string_view {
+		if (fromStdin)
 		{
-			auto mealyTableReader = MealyTableReader{ reader };
-			auto mealyTable = MealyTable{
-				mealyTableReader.GetStates(),
-				mealyTableReader.GetTransitions(),
-				mealyTableReader.GetMealyStates()
+			inputBuffer = ChunkedReader{ stdin }.ReadAll();
+			return inputBuffer;
+		}
+		return inputFile->GetContent();
+	};
+
+	// Outputs are opened only after the input is read and transformed
+	auto writeTable = [&](const auto& table) {
+		stats.MeasurePhase("write", [&] {
+			WriteOutput(outputFileName, options.m_binaryOutput, [&](std::ostream& oFS) {
+				if (options.m_binaryOutput)
+				{
+					BinaryTableWriter{ oFS }.Write(table);
+				}
+				else
+				{
+					TableWriter{ oFS }.Write(table);
+				}
+			});
+		});
+	};
+	auto writeCode = [&](const auto& table) {
+		stats.MeasurePhase("write", [&] {
+			WriteOutput(outputFileName, false, [&](std::ostream& oFS) { CodeWriter{ oFS }.Write(table); });
+		});
+	};
+	auto minimize = [&](auto& table) {
+		stats.SetCounter("states_before", table.GetStates().GetSize());
+		stats.MeasurePhase("minimize", [&] { table.Minimize(options.m_threadsCount); });
+		stats.SetCounter("states_after", table.GetStates().GetSize());
+	};
+	auto readMealyTable = [&] {
+		return stats.MeasurePhase("read", [&] { return ReadMealyTable(getContent()); });
+	};
+	auto readMooreTable = [&] {
+		return stats.MeasurePhase("read", [&] { return ReadMooreTable(getContent()); });
+	};
+
+	if (options.m_mode == ProgramMode::MEALY_MIN)
+	{
+		auto mealyTable = readMealyTable();
+		minimize(mealyTable);
+		writeTable(mealyTable);
+	}
+	if (options.m_mode == ProgramMode::MEALY_TO_MOORE)
+	{
+		auto mealyTable = readMealyTable();
+		auto mooreTable = stats.MeasurePhase("convert", [&] { return MooreTable{ mealyTable }; });
+		stats.SetCounter("states_before", mealyTable.GetStates().GetSize());
+		stats.SetCounter("states_after", mooreTable.GetStates().GetSize());
+		writeTable(mooreTable);
+	}
+	if (options.m_mode == ProgramMode::MOORE_MIN)
+	{
+		auto mooreTable = readMooreTable();
+		minimize(mooreTable);
+		writeTable(mooreTable);
+	}
+	if (options.m_mode == ProgramMode::MOORE_TO_MEALY)
+	{
+		auto mooreTable = readMooreTable();
+		auto mealyTable = stats.MeasurePhase("convert", [&] { return MealyTable{ mooreTable }; });
+		stats.SetCounter("states_before", mooreTable.GetStates().GetSize());
+		stats.SetCounter("states_after", mealyTable.GetStates().GetSize());
+		writeTable(mealyTable);
+	}
+	if (options.m_mode == ProgramMode::DETERMINIZE)
+	{
+		auto nfaTable = stats.MeasurePhase("read", [&] {
+			auto nfaTableReader = NfaTableReader{ getContent() };
+			return NfaTable{
+				nfaTableReader.GetStates(),
+				nfaTableReader.GetTransitions(),
+				nfaTableReader.GetAcceptTags(),
+				nfaTableReader.GetTargets(),
+				nfaTableReader.GetEpsilonTargets()
 			};
-			mealyTable.Minimize();
-			oFS << mealyTable;
+		});
+		auto mooreTable = stats.MeasurePhase("determinize", [&] { return Determinize(nfaTable, options.m_threadsCount); });
+		stats.SetCounter("states_before", nfaTable.GetStates().GetSize());
+		stats.SetCounter("states_after", mooreTable.GetStates().GetSize());
+		writeTable(mooreTable);
+	}
+	if (options.m_mode == ProgramMode::REGEX)
+	{
+		// Every line is a pattern, its matches are accepted with output y<line number>. Blank lines
+		// are skipped but counted, and chunks end at line ends, so numbers run on across chunks
+		auto compiler = RegexCompiler{};
+		auto nfaTable = stats.MeasurePhase("read", [&] {
+			std::uint32_t lineNumber = 0;
+			auto addPatterns = [&](std::string_view content) {
+				while (!content.empty())
+				{
+					auto lineEnd = content.find('\n');
+					auto pattern = content.substr(0, lineEnd);
+					content.remove_prefix(lineEnd == content.npos ? content.size() : lineEnd + 1);
+					++lineNumber;
+
+					if (!pattern.empty() && pattern.back() == '\r')
+					{
+						pattern.remove_suffix(1);
+					}
+					if (!pattern.empty())
+					{
+						compiler.Add(pattern, lineNumber);
+					}
+				}
+			};
+			if (fromStdin)
+			{
+				auto reader = ChunkedReader{ stdin };
+				for (std::string_view chunk{}; reader.ReadChunk(chunk);)
+				{
+					addPatterns(chunk);
+				}
+			}
+			else
+			{
+				addPatterns(getContent());
+			}
+			stats.SetCounter("patterns", compiler.GetPatternsCount());
+			return compiler.Build();
+		});
+		stats.SetCounter("nfa_states", nfaTable.GetStates().GetSize());
+		auto mooreTable = stats.MeasurePhase("determinize", [&] { return Determinize(nfaTable, options.m_threadsCount); });
+		minimize(mooreTable);
+		writeTable(mooreTable);
+
+		// Inputs of the table are byte classes, so the bytes of every class are written next to it
+		auto byteClassesFileName = options.m_byteClassesFileName.empty() && !toStdout
+			? outputFileName + ".classes"
+			: options.m_byteClassesFileName;
+		if (!byteClassesFileName.empty())
+		{
+			WriteOutput(byteClassesFileName, false, [&](std::ostream& byteClassesFS) {
+				WriteByteClasses(byteClassesFS, compiler.GetByteClasses());
+			});
 		}
-		if (mode == ProgramMode::MEALY_TO_MOORE)
+	}
+	if (options.m_mode == ProgramMode::MEALY_CODEGEN)
+	{
+		auto mealyTable = readMealyTable();
+		minimize(mealyTable);
+		writeCode(mealyTable);
+	}
+	if (options.m_mode == ProgramMode::MOORE_CODEGEN)
+	{
+		auto mooreTable = readMooreTable();
+		minimize(mooreTable);
+		writeCode(mooreTable);
+	}
+
+}
+
+// Pairs of input and output files of a batch
+using Batch = std::vector<std::pair<std::string, std::string>>;
+
+// Jobs run in parallel and write through <output-file>.tmp, so no two of them may share an output
+void CheckUniqueOutputs(const Batch& batch)
+{
+	namespace fs = std::filesystem;
+
+	std::vector<fs::path> outputs{};
+	outputs.reserve(batch.size());
+	for (auto& job : batch)
+	{
+		outputs.push_back(fs::absolute(job.second).lexically_normal());
+	}
+	std::sort(outputs.begin(), outputs.end());
+	if (auto duplicate = std::adjacent_find(outputs.begin(), outputs.end()); duplicate != outputs.end())
+	{
+		throw std::invalid_argument(DUPLICATE_OUTPUT_MSG + duplicate->string());
+	}
+}
+
+// Source is a directory, whose regular files are taken in name order, or a manifest with lines
+// <input-file>[;<output-file>]. Outputs are placed into the output directory under the input's file name by default.
+// Throws if two jobs have the same output
+Batch ReadBatch(const std::string& source, const std::string& outputDirectory)
+{
+	namespace fs = std::filesystem;
+
+	Batch result{};
+	if (fs::is_directory(source))
+	{
+		for (auto& entry : fs::directory_iterator{ source })
 		{
-			auto mealyTableReader = MealyTableReader{ reader };
-			auto mooreTable = MooreTable{
-				MealyTable{
-					mealyTableReader.GetStates(),
-					mealyTableReader.GetTransitions(),
-					mealyTableReader.GetMealyStates() }
-			};
-			mooreTable.Minimize();
-			oFS << mooreTable;
+			if (entry.is_regular_file())
+			{
+				result.emplace_back(entry.path().string(), (outputDirectory / entry.path().filename()).string());
+			}
 		}
-		if (mode == ProgramMode::MOORE_MIN)
+		std::sort(result.begin(), result.end());
+		CheckUniqueOutputs(result);
+		return result;
+	}
+
+	auto manifest = MappedFile{ source };
+	auto scanner = TableScanner{ manifest.GetContent() };
+	for (std::string_view line{}; scanner.ReadLine(line);)
+	{
+		std::string_view inputFileName{};
+		std::string_view outputFileName{};
+		FieldsRange fields{ line };
+		fields.Next(inputFileName);
+		if (!fields.Next(outputFileName) || outputFileName.empty())
 		{
-			auto mooreTableReader = MooreTableReader{ reader };
-			auto mooreTable = MooreTable{
-				mooreTableReader.GetSignals(),
-				mooreTableReader.GetStates(),
-				mooreTableReader.GetTransitions(),
-				mooreTableReader.GetMooreStates()
-			};
-			mooreTable.Minimize();
-			oFS << mooreTable;
+			result.emplace_back(inputFileName, (outputDirectory / fs::path(inputFileName).filename()).string());
 		}
-		if (mode == ProgramMode::MOORE_TO_MEALY)
+		else
 		{
-			auto mooreTableReader = MooreTableReader{ reader };
-			auto mealyTable = MealyTable{
-				MooreTable{
-					mooreTableReader.GetSignals(),
-					mooreTableReader.GetStates(),
-					mooreTableReader.GetTransitions(),
-					mooreTableReader.GetMooreStates() }
-			};
-			oFS << mealyTable;
+			result.emplace_back(inputFileName, (outputDirectory / fs::path(outputFileName)).string());
+		}
+	}
+	CheckUniqueOutputs(result);
+	return result;
+}
+
+// Runs the jobs of the batch on threadsCount threads, each job on one thread. A failed job is reported
+// and doesn't stop the others. Returns the count of failed jobs
+size_t RunBatch(const JobOptions& options, const Batch& batch, size_t threadsCount, JobStats& stats)
+{
+	auto jobOptions = options;
+	jobOptions.m_threadsCount = 1;
+
+	std::mutex mutex{};
+	size_t failedCount = 0;
+	ParallelForEach(threadsCount, batch.size(), [&](size_t i) {
+		auto& [inputFileName, outputFileName] = batch[i];
+		auto jobStats = JobStats{};
+		std::string error{};
+		auto failed = false;
+		try
+		{
+			std::filesystem::create_directories(std::filesystem::path(outputFileName).parent_path());
+			RunJob(jobOptions, inputFileName, outputFileName, jobStats);
+		}
+		catch (const std::exception& e)
+		{
+			error = e.what();
+			failed = true;
+		}
+
+		std::lock_guard lock{ mutex };
+		stats.Merge(jobStats);
+		if (failed)
+		{
+			++failedCount;
+			std::cout << inputFileName << ": " << error << std::endl;
+		}
+	});
+
+	stats.SetCounter("files", batch.size());
+	stats.SetCounter("failed_files", failedCount);
+	return failedCount;
+}
+
+int main(int argc, char* argv[])
+{
+	auto program = ParseArgs(argc, argv);
+
+	// Tables are written to stdout by "-" through std::cout, and stdin is read through C stdio only
+	std::ios::sync_with_stdio(false);
+#if defined(_WIN32)
+	_setmode(_fileno(stdin), _O_BINARY);
+	_setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+	auto& inputFileName = program.get(INPUT_FILE_PAR);
+	auto& outputFileName = program.get(OUTPUT_FILE_PAR);
+
+	auto options = JobOptions{};
+	options.m_mode = program.get<ProgramMode>(MODE_PAR);
+	options.m_threadsCount = program.get<size_t>(THREADS_PAR);
+	if (options.m_threadsCount == 0)
+	{
+		options.m_threadsCount = GetDefaultThreadsCount();
+	}
+	options.m_binaryOutput = program.get(OUT_FORMAT_PAR) == BIN_FORMAT;
+	options.m_byteClassesFileName = program.get(BYTE_CLASSES_FILE_PAR);
+	auto printStats = program.get<bool>(STATS_PAR);
+	auto& statsFileName = program.get(STATS_FILE_PAR);
+
+	auto stats = JobStats{};
+	auto writeStats = [&] {
+		if (printStats)
+		{
+			stats.WriteJson(std::cerr);
+		}
+		if (!statsFileName.empty())
+		{
+			std::ofstream statsFS{ statsFileName };
+			stats.WriteJson(statsFS);
 		}
+	};
+
+	try
+	{
+		if (program.get<bool>(BATCH_PAR))
+		{
+			std::filesystem::create_directories(outputFileName);
+			auto batch = ReadBatch(inputFileName, outputFileName);
+			auto failedCount = RunBatch(options, batch, options.m_threadsCount, stats);
+			writeStats();
+			std::cout << "Processed " << batch.size() << " files, failed " << failedCount << std::endl;
+			return failedCount == 0 ? 0 : 1;
+		}
+
+		RunJob(options, inputFileName, outputFileName, stats);
+		writeStats();
 	}
 	catch (const std::exception& e)
 	{
-		std::cout << e.what() << std::endl;
+		// Errors mustn't mix with the table written to stdout
+		(outputFileName == STD_STREAM_NAME ? std::cerr : std::cout) << e.what() << std::endl;
 		std::exit(1);
 	}
 
@@ -12,7 +12,11 @@ argparse::ArgumentParser ParseArgs(int argc, char* argv[])
 			std::string(MEALY_TO_MOORE) + '|' +
 			std::string(MOORE_TO_MEALY) + '|' +
 			std::string(MEALY_MIN) + '|' +
-			std::string(MOORE_MIN) + '}')
+			std::string(MOORE_MIN) + '|' +
+			std::string(DETERMINIZE) + '|' +
+			std::string(REGEX) + '|' +
+			std::string(MEALY_CODEGEN) + '|' +
+			std::string(MOORE_CODEGEN) + '}')
 		.action([](const auto& s) noexcept {
 			return StringToProgramMode(s);
 		})
@@ -20,15 +24,45 @@ argparse::ArgumentParser ParseArgs(int argc, char* argv[])
 		.required();
 
 	program.add_argument(INPUT_FILE_PAR)
-		.help("source file with source automaton")
+		.help("source file with source automaton, - for stdin")
 		.nargs(1)
 		.required();
 
 	program.add_argument(OUTPUT_FILE_PAR)
-		.help("destination file")
+		.help("destination file, - for stdout")
 		.nargs(1)
 		.required();
 
+	program.add_argument(THREADS_PAR)
+		.help("threads count for minimization of huge tables, 0 means all hardware threads")
+		.default_value(size_t{ 1 })
+		.scan<'u', size_t>();
+
+	program.add_argument(OUT_FORMAT_PAR)
+		.help("format of the written table {" +
+			std::string(CSV_FORMAT) + '|' +
+			std::string(BIN_FORMAT) + "}, binary tables are read back by Mealy and Moore modes")
+		.default_value(std::string(CSV_FORMAT));
+
+	program.add_argument(STATS_PAR)
+		.help("write JSON with time, peak memory and counters of every phase to stderr")
+		.default_value(false)
+		.implicit_value(true);
+
+	program.add_argument(STATS_FILE_PAR)
+		.help("write the same JSON to the file")
+		.default_value(std::string());
+
+	program.add_argument(BATCH_PAR)
+		.help("treat " + std::string(INPUT_FILE_PAR) + " as a directory or a manifest with lines <input-file>[;<output-file>] and "
+			+ std::string(OUTPUT_FILE_PAR) + " as the output directory, files are processed on " + std::string(THREADS_PAR) + " threads")
+		.default_value(false)
+		.implicit_value(true);
+
+	program.add_argument(BYTE_CLASSES_FILE_PAR)
+		.help("file for bytes of every input of " + std::string(REGEX) + " mode, <output-file>.classes by default")
+		.default_value(std::string());
+
 	try
 	{
 		program.parse_args(argc, argv);
@@ -37,6 +71,21 @@ argparse::ArgumentParser ParseArgs(int argc, char* argv[])
 		{
 			throw std::invalid_argument("Wrong " + std::string(MODE_PAR) + " provided. See help");
 		}
+		if (auto& format = program.get(OUT_FORMAT_PAR);
+			format != CSV_FORMAT && format != BIN_FORMAT)
+		{
+			throw std::invalid_argument("Wrong " + std::string(OUT_FORMAT_PAR) + " provided. See help");
+		}
+		if (program.get<bool>(BATCH_PAR)
+			&& (program.get(INPUT_FILE_PAR) == STD_STREAM_NAME || program.get(OUTPUT_FILE_PAR) == STD_STREAM_NAME))
+		{
+			throw std::invalid_argument(std::string(BATCH_PAR) + " doesn't support " + STD_STREAM_NAME + " as a file. See help");
+		}
+		if (program.get<bool>(BATCH_PAR) && !program.get(BYTE_CLASSES_FILE_PAR).empty())
+		{
+			throw std::invalid_argument(std::string(BATCH_PAR) + " writes byte classes next to every output, "
+				+ BYTE_CLASSES_FILE_PAR + " isn't supported. See help");
+		}
 	}
 	catch (const std::exception& err)
 	{
@@ -0,0 +1,34 @@
+#include <cstdlib>
+#include <new>
+
+#include "../../include/Automata/StatsCounters.hpp"
+
+// Replaces global operator new to count allocations of the tool for --stats. Array, nothrow and
+// sized forms come to these by default; over-aligned allocations aren't counted
+void* operator new(std::size_t size)
+{
+	StatsCounters::Add(StatsCounter::ALLOCATIONS);
+	while (true)
+	{
+		if (auto result = std::malloc(size == 0 ? 1 : size))
+		{
+			return result;
+		}
+		auto handler = std::get_new_handler();
+		if (!handler)
+		{
+			throw std::bad_alloc();
+		}
+		handler();
+	}
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
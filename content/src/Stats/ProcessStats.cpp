@@ -0,0 +1,63 @@
+#include "../../include/Automata/Stats.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+double GetProcessCpuSeconds() noexcept
+{
+#if defined(_WIN32)
+	FILETIME creation{};
+	FILETIME exit{};
+	FILETIME kernel{};
+	FILETIME user{};
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+	{
+		return 0;
+	}
+	auto toTicks = [](const FILETIME& time) {
+		return (static_cast<std::uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+	};
+	return static_cast<double>(toTicks(kernel) + toTicks(user)) * 1e-7;
+#else
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+	auto toSeconds = [](const timeval& time) {
+		return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_usec) * 1e-6;
+	};
+	return toSeconds(usage.ru_utime) + toSeconds(usage.ru_stime);
+#endif
+}
+
+std::uint64_t GetPeakRssBytes() noexcept
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters{};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return 0;
+	}
+	return counters.PeakWorkingSetSize;
+#else
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+#if defined(__APPLE__)
+	return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+	return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
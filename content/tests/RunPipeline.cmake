@@ -0,0 +1,55 @@
+# Transforms a table by the tool and checks the result against the source:
+#   cmake -DGENERATE=<automata_generate> -DAUTOMATA=<automata> -DCHECK=<automata_tests> -DWORK_DIR=<dir>
+#         -DNAME=<test> -DSOURCE_KIND=<kind> -DRESULT_KIND=<kind> -DMODE=<mode>
+#         [-DSOURCE=<file> | "-DGENERATE_ARGS=<args>"] "-DAUTOMATA_ARGS=<args>" [-DSTATES_COUNT=<count>]
+#         -P RunPipeline.cmake
+# The source is generated by automata_generate unless SOURCE is given. Arguments are separated
+# by spaces, as lists can't be passed through add_test
+separate_arguments(GENERATE_ARGS UNIX_COMMAND "${GENERATE_ARGS}")
+separate_arguments(AUTOMATA_ARGS UNIX_COMMAND "${AUTOMATA_ARGS}")
+
+function(check_same_files LHS RHS MESSAGE)
+    execute_process(
+                   COMMAND "${CMAKE_COMMAND}" -E compare_files "${LHS}" "${RHS}"
+                   RESULT_VARIABLE COMPARE_RESULT
+    )
+    if(NOT COMPARE_RESULT EQUAL 0)
+        message(FATAL_ERROR "${MESSAGE}")
+    endif()
+endfunction()
+
+file(MAKE_DIRECTORY "${WORK_DIR}")
+set(RESULT_FILE "${WORK_DIR}/${NAME}.result")
+if(SOURCE)
+    set(SOURCE_FILE "${SOURCE}")
+else()
+    set(SOURCE_FILE "${WORK_DIR}/${NAME}.source")
+    execute_process(
+                   COMMAND "${GENERATE}" ${SOURCE_KIND} "${SOURCE_FILE}" ${GENERATE_ARGS}
+                   COMMAND_ERROR_IS_FATAL ANY
+    )
+endif()
+
+execute_process(
+               COMMAND "${AUTOMATA}" ${AUTOMATA_ARGS} ${MODE} "${SOURCE_FILE}" "${RESULT_FILE}"
+               COMMAND_ERROR_IS_FATAL ANY
+)
+execute_process(
+               COMMAND "${CHECK}" equivalent ${SOURCE_KIND} "${SOURCE_FILE}" ${RESULT_KIND} "${RESULT_FILE}" ${STATES_COUNT}
+               COMMAND_ERROR_IS_FATAL ANY
+)
+
+# Minimization gives the same table on one thread and on several ones, and keeps a minimal table as it is
+if(MODE STREQUAL SOURCE_KIND)
+    execute_process(
+                   COMMAND "${AUTOMATA}" ${AUTOMATA_ARGS} --threads 4 ${MODE} "${SOURCE_FILE}" "${RESULT_FILE}.parallel"
+                   COMMAND_ERROR_IS_FATAL ANY
+    )
+    check_same_files("${RESULT_FILE}" "${RESULT_FILE}.parallel" "Minimization on 4 threads differs from the one on 1 thread")
+
+    execute_process(
+                   COMMAND "${AUTOMATA}" ${AUTOMATA_ARGS} ${MODE} "${RESULT_FILE}" "${RESULT_FILE}.again"
+                   COMMAND_ERROR_IS_FATAL ANY
+    )
+    check_same_files("${RESULT_FILE}" "${RESULT_FILE}.again" "Minimization of a minimized table changed it")
+endif()
@@ -0,0 +1,472 @@
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <queue>
+#include <random>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Automata/BatchSimulator.hpp"
+#include "Automata/BinaryTable.hpp"
+#include "Automata/MealyTableReader.hpp"
+#include "Automata/MooreTableReader.hpp"
+#include "Automata/NfaTableReader.hpp"
+#include "Automata/Regex.hpp"
+#include "Automata/Simulator.hpp"
+#include "Automata/StaticTable.hpp"
+#include "Automata/TableGenerator.hpp"
+
+// Checks of the tool run by CTest:
+//   automata_tests equivalent <mealy|moore|nfa> <source-file> <mealy|moore> <result-file> [<states-count>]
+//   automata_tests simulators
+//   automata_tests regex
+// The first one compares a table with the one the tool made of it, exactly, by walking pairs
+// of their states from the start ones, and checks the states count of the result if it's given. The second compares parallel and batch simulators with
+// the sequential one on generated tables. The third checks that wrong patterns leave no trace
+// in the regex compiler
+namespace
+{
+
+using Id = TransitionMatrix::Id;
+
+constexpr auto MEALY_KIND = "mealy";
+constexpr auto MOORE_KIND = "moore";
+constexpr auto NFA_KIND = "nfa";
+
+constexpr size_t SIMULATION_INPUT_SIZE = 1 << 20;
+constexpr size_t SIMULATION_INPUTS_COUNT = 8;
+constexpr size_t SIMULATION_SIGNALS_COUNT = 4;
+constexpr size_t BATCH_STREAMS_COUNT = 5000;
+constexpr size_t BATCH_MAX_STREAM_SIZE = 100;
+constexpr std::uint32_t SEED = 42;
+
+// Failed parses leave their outputs unchanged, even when the first name is valid
+static_assert([] {
+	std::string_view stateName = "a";
+	std::string_view signalName = "b";
+	return TrySplitMealyState("q1/1w", stateName, signalName) != StateParseError::NONE
+		&& stateName == "a" && signalName == "b";
+}());
+
+// Static tables are parsed by the compiler, so their checks are compile errors
+using StaticMealy = StaticMealyTable<";q0;q1;q2\nz1;q1/w1;q2/w0;q0/w1\nz2;q0/w0;q2/w1;q1/w0\n">;
+static_assert(StaticMealy::STATES_COUNT == 3 && StaticMealy::INPUTS_COUNT == 2 && StaticMealy::GetSignalsCount() == 2);
+static_assert(StaticMealy::GetStateId("q2") == 2 && StaticMealy::GetInputId("z2") == 1);
+static_assert(StaticMealy::Step(StaticMealy::GetStateId("q0"), StaticMealy::GetInputId("z1")) == StaticMealy::GetStateId("q1"));
+static_assert(StaticMealy::Step(StaticMealy::GetStateId("q2"), StaticMealy::GetInputId("z2")) == StaticMealy::GetStateId("q1"));
+static_assert(StaticMealy::GetOutput(StaticMealy::GetStateId("q1"), StaticMealy::GetInputId("z1")) == StaticMealy::GetSignalId("w0"));
+static_assert(StaticMealy::GetSignalName(StaticMealy::GetOutput(StaticMealy::GetStateId("q1"), StaticMealy::GetInputId("z2"))) == "w1");
+
+using StaticMoore = StaticMooreTable<";y1;y2;y1\n;s0;s1;s2\nz1;s1;s2;s0\nz2;s0;s0;s2\n">;
+static_assert(StaticMoore::STATES_COUNT == 3 && StaticMoore::INPUTS_COUNT == 2 && StaticMoore::GetSignalsCount() == 2);
+static_assert(StaticMoore::GetStateId("s1") == 1 && StaticMoore::GetInputId("z1") == 0);
+static_assert(StaticMoore::Step(StaticMoore::GetStateId("s1"), StaticMoore::GetInputId("z1")) == StaticMoore::GetStateId("s2"));
+static_assert(StaticMoore::Step(StaticMoore::GetStateId("s2"), StaticMoore::GetInputId("z2")) == StaticMoore::GetStateId("s2"));
+static_assert(StaticMoore::GetOutput(StaticMoore::GetStateId("s1")) == StaticMoore::GetSignalId("y2"));
+static_assert(StaticMoore::GetOutput(StaticMoore::GetStateId("s0")) == StaticMoore::GetOutput(StaticMoore::GetStateId("s2")));
+
+void Check(bool isTrue, const std::string& message)
+{
+	if (!isTrue)
+	{
+		throw std::logic_error(message);
+	}
+}
+
+// Deterministic automaton with names of outputs, so tables of both kinds are compared alike.
+// Output of a Moore transition is the signal of its target
+struct Machine
+{
+	SymbolTable m_inputs;
+	TransitionMatrix m_targets;
+	// Output of every cell of targets, input-major as they are
+	std::vector<std::string> m_outputs;
+	// Signals of states, Moore tables only
+	std::vector<std::string> m_stateSignals;
+};
+
+Machine MakeMachine(const MealyTable& table)
+{
+	auto& targets = table.GetTargets();
+	std::vector<std::string> outputs{};
+	outputs.reserve(targets.GetCells().size());
+	for (auto output : table.GetOutputs().GetCells())
+	{
+		outputs.push_back(table.GetSignals().GetName(output));
+	}
+	return Machine{ table.GetTransitions(), targets, std::move(outputs), {} };
+}
+
+Machine MakeMachine(const MooreTable& table)
+{
+	std::vector<std::string> stateSignals{};
+	stateSignals.reserve(table.GetStateSignals().size());
+	for (auto signal : table.GetStateSignals())
+	{
+		stateSignals.push_back(table.GetSignals().GetName(signal));
+	}
+
+	auto& targets = table.GetTargets();
+	std::vector<std::string> outputs{};
+	outputs.reserve(targets.GetCells().size());
+	for (auto target : targets.GetCells())
+	{
+		outputs.push_back(stateSignals[target]);
+	}
+	return Machine{ table.GetTransitions(), targets, std::move(outputs), std::move(stateSignals) };
+}
+
+// Input ids of rhs by input ids of lhs
+std::vector<Id> MatchInputs(const SymbolTable& lhs, const SymbolTable& rhs)
+{
+	Check(lhs.GetSize() == rhs.GetSize(), "Tables have different inputs");
+	std::vector<Id> result{};
+	for (auto& name : lhs.GetNames())
+	{
+		auto id = rhs.FindId(name);
+		Check(id.has_value(), "Input " + name + " is missing in the result table");
+		result.push_back(*id);
+	}
+	return result;
+}
+
+// Walks pairs of states reached by the same inputs from the start states. Tables are equivalent
+// if outputs of every such pair are equal
+void CheckEquivalent(const Machine& lhs, const Machine& rhs)
+{
+	auto rhsInputs = MatchInputs(lhs.m_inputs, rhs.m_inputs);
+	auto compareSignals = !lhs.m_stateSignals.empty() && !rhs.m_stateSignals.empty();
+	const auto rhsStatesCount = rhs.m_targets.GetStatesCount();
+
+	std::unordered_set<std::uint64_t> visited{ 0 };
+	std::queue<std::pair<Id, Id>> pairs{};
+	pairs.emplace(0, 0);
+	while (!pairs.empty())
+	{
+		auto [lhsState, rhsState] = pairs.front();
+		pairs.pop();
+		Check(!compareSignals || lhs.m_stateSignals[lhsState] == rhs.m_stateSignals[rhsState],
+			"Signals of states differ after the same inputs");
+
+		for (size_t input = 0; input < lhs.m_inputs.GetSize(); ++input)
+		{
+			auto lhsCell = input * lhs.m_targets.GetStatesCount() + lhsState;
+			auto rhsCell = rhsInputs[input] * rhsStatesCount + rhsState;
+			Check(lhs.m_outputs[lhsCell] == rhs.m_outputs[rhsCell],
+				"Outputs differ on input " + lhs.m_inputs.GetName(static_cast<Id>(input)));
+
+			auto lhsTarget = lhs.m_targets.GetCells()[lhsCell];
+			auto rhsTarget = rhs.m_targets.GetCells()[rhsCell];
+			if (visited.insert(std::uint64_t{ lhsTarget } * rhsStatesCount + rhsTarget).second)
+			{
+				pairs.emplace(lhsTarget, rhsTarget);
+			}
+		}
+	}
+}
+
+// Sorted NFA states reached from the states by epsilon transitions, the states included
+std::vector<Id> GetClosure(const NfaTable& nfa, std::vector<Id> states)
+{
+	std::set<Id> result(states.begin(), states.end());
+	while (!states.empty())
+	{
+		auto state = states.back();
+		states.pop_back();
+		for (auto target : nfa.GetEpsilonTargets().At(0, state))
+		{
+			if (result.insert(target).second)
+			{
+				states.push_back(target);
+			}
+		}
+	}
+	return { result.begin(), result.end() };
+}
+
+// Walks subsets of NFA states paired with DFA states. Signal of a DFA state must be
+// y<tag> of the accepted token of highest priority in its subset, y0 if there is none
+void CheckEquivalent(const NfaTable& nfa, const Machine& dfa)
+{
+	auto dfaInputs = MatchInputs(nfa.GetTransitions(), dfa.m_inputs);
+	Check(!dfa.m_stateSignals.empty(), "Determinized table must be a Moore table");
+	const auto dfaStatesCount = dfa.m_targets.GetStatesCount();
+
+	using Pair = std::pair<std::vector<Id>, Id>;
+	std::set<Pair> visited{};
+	std::queue<Pair> pairs{};
+	pairs.emplace(GetClosure(nfa, { 0 }), 0);
+	visited.insert(pairs.front());
+	while (!pairs.empty())
+	{
+		auto [subset, dfaState] = pairs.front();
+		pairs.pop();
+
+		std::uint32_t tag = 0;
+		for (auto state : subset)
+		{
+			auto stateTag = nfa.GetAcceptTags()[state];
+			if (stateTag != 0 && (tag == 0 || stateTag < tag))
+			{
+				tag = stateTag;
+			}
+		}
+		Check(dfa.m_stateSignals[dfaState] == "y" + std::to_string(tag), "Accepted tokens differ after the same inputs");
+
+		for (size_t input = 0; input < nfa.GetTransitions().GetSize(); ++input)
+		{
+			std::vector<Id> targets{};
+			for (auto state : subset)
+			{
+				auto stateTargets = nfa.GetTargets().At(input, state);
+				targets.insert(targets.end(), stateTargets.begin(), stateTargets.end());
+			}
+			auto pair = Pair{ GetClosure(nfa, std::move(targets)), dfa.m_targets.GetCells()[dfaInputs[input] * dfaStatesCount + dfaState] };
+			if (visited.insert(pair).second)
+			{
+				pairs.push(std::move(pair));
+			}
+		}
+	}
+}
+
+Machine ReadMachine(std::string_view kind, const std::string& fileName)
+{
+	auto file = MappedFile{ fileName };
+	auto content = file.GetContent();
+	if (kind == MEALY_KIND)
+	{
+		if (IsBinaryTable(content))
+		{
+			return MakeMachine(BinaryTableView{ content }.ToMealyTable());
+		}
+		auto reader = MealyTableReader{ content };
+		return MakeMachine(MealyTable{ reader.GetStates(), reader.GetTransitions(), reader.GetSignals(), reader.GetTargets(), reader.GetOutputs() });
+	}
+	if (kind == MOORE_KIND)
+	{
+		if (IsBinaryTable(content))
+		{
+			return MakeMachine(BinaryTableView{ content }.ToMooreTable());
+		}
+		auto reader = MooreTableReader{ content };
+		return MakeMachine(MooreTable{ reader.GetSignals(), reader.GetStateSignals(), reader.GetStates(), reader.GetTransitions(), reader.GetTargets() });
+	}
+	throw std::invalid_argument("Wrong table kind " + std::string(kind));
+}
+
+void RunEquivalent(std::string_view sourceKind,
+	const std::string& sourceFileName,
+	std::string_view resultKind,
+	const std::string& resultFileName,
+	std::optional<size_t> statesCount)
+{
+	auto result = ReadMachine(resultKind, resultFileName);
+	if (statesCount)
+	{
+		Check(result.m_targets.GetStatesCount() == *statesCount, "Result has " + std::to_string(result.m_targets.GetStatesCount())
+			+ " states instead of " + std::to_string(*statesCount));
+	}
+	if (sourceKind != NFA_KIND)
+	{
+		CheckEquivalent(ReadMachine(sourceKind, sourceFileName), result);
+		return;
+	}
+
+	auto file = MappedFile{ sourceFileName };
+	auto reader = NfaTableReader{ file.GetContent() };
+	auto nfa = NfaTable{ reader.GetStates(), reader.GetTransitions(), reader.GetAcceptTags(), reader.GetTargets(), reader.GetEpsilonTargets() };
+	CheckEquivalent(nfa, result);
+}
+
+std::vector<Id> MakeRandomInputs(size_t size, size_t inputsCount, std::mt19937& random)
+{
+	std::vector<Id> result(size);
+	for (auto& input : result)
+	{
+		input = static_cast<Id>(random() % inputsCount);
+	}
+	return result;
+}
+
+// Every input shifts the state by input + 1, so paths from different states never meet
+// and parallel runs give up their speculation
+MealyTable MakeCycleTable(size_t statesCount)
+{
+	TransitionMatrix targets{ SIMULATION_INPUTS_COUNT, statesCount };
+	TransitionMatrix outputs{ SIMULATION_INPUTS_COUNT, statesCount };
+	for (size_t input = 0; input < SIMULATION_INPUTS_COUNT; ++input)
+	{
+		for (size_t state = 0; state < statesCount; ++state)
+		{
+			targets.At(input, state) = static_cast<Id>((state + input + 1) % statesCount);
+			outputs.At(input, state) = static_cast<Id>(state % SIMULATION_SIGNALS_COUNT);
+		}
+	}
+
+	return MealyTable{
+		SymbolTable::MakeIndexed('q', statesCount),
+		SymbolTable::MakeIndexed('z', SIMULATION_INPUTS_COUNT),
+		SymbolTable::MakeIndexed('w', SIMULATION_SIGNALS_COUNT),
+		targets,
+		outputs
+	};
+}
+
+// Parallel runs against the sequential one, with threads counts that do and don't divide the input
+void CheckParallelRun(std::string_view name, const MealyTable& table, std::span<const Id> inputs)
+{
+	auto simulator = MealySimulator{ table };
+	const auto startState = static_cast<Id>(table.GetStates().GetSize() / 2);
+	std::vector<Id> outputs(inputs.size());
+	auto state = simulator.Run(startState, inputs, outputs);
+
+	std::vector<Id> parallelOutputs(inputs.size());
+	for (size_t threadsCount : { 2, 3, 8 })
+	{
+		auto parallelState = simulator.RunParallel(startState, inputs, parallelOutputs, threadsCount);
+		Check(parallelState == state && parallelOutputs == outputs,
+			std::string(name) + ": parallel run on " + std::to_string(threadsCount) + " threads differs from the sequential one");
+	}
+	std::cout << name << ": ok" << std::endl;
+}
+
+void RunSimulators()
+{
+	std::mt19937 random{ SEED };
+	auto inputs = MakeRandomInputs(SIMULATION_INPUT_SIZE, SIMULATION_INPUTS_COUNT, random);
+
+	// Small tables are run from all states, big ones from a guessed state
+	GeneratorParams params{};
+	params.m_inputsCount = SIMULATION_INPUTS_COUNT;
+	params.m_signalsCount = SIMULATION_SIGNALS_COUNT;
+	params.m_seed = SEED;
+	params.m_statesCount = 1000;
+	auto smallTable = TableGenerator{ params }.MakeMealyTable();
+	params.m_statesCount = 20000;
+	auto bigTable = TableGenerator{ params }.MakeMealyTable();
+
+	CheckParallelRun("parallel/small", smallTable, inputs);
+	CheckParallelRun("parallel/big", bigTable, inputs);
+	CheckParallelRun("parallel/small-cycle", MakeCycleTable(1000), inputs);
+	CheckParallelRun("parallel/big-cycle", MakeCycleTable(20000), inputs);
+
+	// Moore table converted from Mealy one gives outputs of the same names from its first state
+	auto mealySimulator = MealySimulator{ bigTable };
+	auto mooreTable = MooreTable{ bigTable };
+	std::vector<Id> mealyOutputs(inputs.size());
+	std::vector<Id> mooreOutputs(inputs.size());
+	mealySimulator.Run(0, inputs, mealyOutputs);
+	MooreSimulator{ mooreTable }.Run(0, inputs, mooreOutputs);
+	for (size_t i = 0; i < inputs.size(); ++i)
+	{
+		Check(bigTable.GetSignals().GetName(mealyOutputs[i]) == mooreTable.GetSignals().GetName(mooreOutputs[i]),
+			"moore: outputs differ from the ones of the Mealy table");
+	}
+	std::cout << "moore: ok" << std::endl;
+
+	// Ragged streams, empty ones included, from random states: lockstep lanes against one by one runs
+	std::vector<Id> offsets{ 0 };
+	for (size_t stream = 0; stream < BATCH_STREAMS_COUNT; ++stream)
+	{
+		offsets.push_back(static_cast<Id>(offsets.back() + random() % BATCH_MAX_STREAM_SIZE));
+	}
+	std::span<const Id> streamsInputs{ inputs.data(), offsets.back() };
+	std::vector<Id> states(BATCH_STREAMS_COUNT);
+	for (auto& state : states)
+	{
+		state = static_cast<Id>(random() % bigTable.GetStates().GetSize());
+	}
+
+	auto singleStates = states;
+	std::vector<Id> singleOutputs(streamsInputs.size());
+	for (size_t stream = 0; stream < states.size(); ++stream)
+	{
+		singleStates[stream] = mealySimulator.Run(singleStates[stream],
+			streamsInputs.subspan(offsets[stream], offsets[stream + 1] - offsets[stream]),
+			std::span{ singleOutputs }.subspan(offsets[stream]));
+	}
+
+	std::vector<Id> batchOutputs(streamsInputs.size());
+	MealyBatchSimulator{ bigTable }.Run(streamsInputs, offsets, states, batchOutputs);
+	Check(states == singleStates && batchOutputs == singleOutputs, "batch: results differ from one by one runs");
+	std::cout << "batch: ok" << std::endl;
+}
+
+// Wrong patterns, one of them with a class of its own, between good ones give the same NFA
+// as the good ones alone
+void RunRegex()
+{
+	auto compiler = RegexCompiler{};
+	auto expected = RegexCompiler{};
+	compiler.Add("ab", 1);
+	expected.Add("ab", 1);
+	for (auto pattern : { "x[yz](", "q*)" })
+	{
+		auto isThrown = false;
+		try
+		{
+			compiler.Add(pattern, 2);
+		}
+		catch (const std::invalid_argument&)
+		{
+			isThrown = true;
+		}
+		Check(isThrown, "regex: pattern " + std::string(pattern) + " must be rejected");
+	}
+	compiler.Add("c.d", 3);
+	expected.Add("c.d", 3);
+
+	auto nfa = compiler.Build();
+	auto expectedNfa = expected.Build();
+	Check(compiler.GetPatternsCount() == expected.GetPatternsCount()
+			&& nfa.GetStates().GetSize() == expectedNfa.GetStates().GetSize()
+			&& nfa.GetTransitions().GetSize() == expectedNfa.GetTransitions().GetSize()
+			&& nfa.GetAcceptTags() == expectedNfa.GetAcceptTags()
+			&& compiler.GetByteClasses() == expected.GetByteClasses(),
+		"regex: rejected patterns changed the compiler");
+	std::cout << "regex: ok" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		std::vector<std::string> args(argv + 1, argv + argc);
+		if ((args.size() == 5 || args.size() == 6) && args[0] == "equivalent")
+		{
+			auto statesCount = args.size() == 6 ? std::optional<size_t>{ std::stoull(args[5]) } : std::nullopt;
+			RunEquivalent(args[1], args[2], args[3], args[4], statesCount);
+			std::cout << args[4] << " is equivalent to " << args[2] << std::endl;
+			return 0;
+		}
+		if (args.size() == 1 && args[0] == "simulators")
+		{
+			RunSimulators();
+			return 0;
+		}
+		if (args.size() == 1 && args[0] == "regex")
+		{
+			RunRegex();
+			return 0;
+		}
+
+		std::cout << "Usage: automata_tests equivalent <mealy|moore|nfa> <source-file> <mealy|moore> <result-file> [<states-count>]" << std::endl
+				  << "       automata_tests simulators" << std::endl
+				  << "       automata_tests regex" << std::endl;
+		return 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << e.what() << std::endl;
+		return 1;
+	}
+}